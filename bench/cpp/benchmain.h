@@ -0,0 +1,710 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/benchmain.h
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	The parts of the test benches for main.v (main_tb.cpp) and
+//		hdmiddr.v (ddr_tb.cpp) that don't depend upon the design:
+//	the A/D, the checkers, what's done with every frame, the command line
+//	and scenario handling, and the parameter sweeps.  Include this after
+//	defining BASE, VVAR(), and the video decoder or window.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#ifndef	BENCHMAIN_H
+#define	BENCHMAIN_H
+
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "testb.h"
+#include "micnco.h"
+#include "scenario.h"
+#include "frameout.h"
+#include "scoreboard.h"
+#ifdef	SWEEP
+#include "threadpool.h"
+#endif
+
+// Samples kept by -p
+static	const	int	PROBE_DEPTH = 65536;
+
+// BENCHMAIN
+// {{{
+// Everything the test benches for main.v and hdmiddr.v have in common: the
+// A/D, the checkers, and what's done with each frame once it's decoded.
+// TB must provide video(), returning its decoder (or window), and may hide
+// save_devices(), restore_devices(), and new_frame() to add to them.
+template <class VA, class TB>	class BENCHMAIN : public TESTB<VA, TB> {
+public:
+	MICNCO		m_micnco;
+	unsigned	m_adc_clocks;	// Only used with ADC_BYPASS
+	unsigned long	m_maxframes, m_last_frame;
+	FRAMEOUT	m_out;
+	SCOREBOARD	m_sb;
+
+	BENCHMAIN(void) {
+		this->m_core->i_reset = 1;
+		m_adc_clocks = 0;
+		m_maxframes = 180;
+		m_last_frame = 0;
+		this->m_core->i_cmap = 4;
+#ifndef	HEADLESS
+		Glib::signal_idle().connect(sigc::mem_fun((*this),
+				&BENCHMAIN::on_tick));
+#endif
+	}
+
+	TB	*tb(void) { return static_cast<TB *>(this); }
+
+	// add_probes()
+	// {{{
+	// Names the signals, common to both designs, that may be probed or
+	// traced upon.  fil_bits is the width of the filter's output.
+	void	add_probes(int fil_bits) {
+		VA	*c = this->m_core;
+
+		this->m_probes.add("adc_ce", &c->VVAR(_adc_ce));
+		this->m_probes.add("adc_sample", &c->VVAR(_adc_sample), 12);
+		this->m_probes.add("fil_ce", &c->VVAR(_fil_ce));
+		this->m_probes.add("fil_sample", &c->VVAR(_fil_sample),
+								fil_bits);
+		this->m_probes.add("pre_ce", &c->VVAR(_pre_ce));
+		this->m_probes.add("pre_sample", &c->VVAR(_pre_sample), 12);
+		this->m_probes.add("fft_sample", &c->VVAR(_fft_sample));
+		this->m_probes.add("fft_sync", &c->VVAR(_fft_sync));
+		this->m_probes.add("raw_sync", &c->VVAR(_raw_sync));
+		this->m_probes.add("raw_pixel", &c->VVAR(_raw_pixel), 8);
+		this->m_probes.add("dat_stall", &c->VVAR(_dat_stall));
+		this->m_probes.add("video_refresh",
+						&c->VVAR(_video_refresh));
+	}
+	// }}}
+
+	void	close(void) {
+		this->m_done = true;
+	}
+
+	void	sim_clk_tick(void) {
+		// {{{
+		// Before changing anything the design might see
+		if (m_sb.active())
+			m_sb.sample();
+#ifdef	ADC_BYPASS
+		// Skip the SPI port, and hand the design a new sample every
+		// 100 clocks (1 Msps) directly
+		this->m_core->i_adc_ce = 0;
+		if (++m_adc_clocks >= 100) {
+			m_adc_clocks = 0;
+			this->m_core->i_adc_ce = 1;
+			this->m_core->i_adc_sample = m_micnco.adc_word();
+		}
+#else
+		this->m_core->i_adc_miso = m_micnco(this->m_core->o_adc_sck,
+					this->m_core->o_adc_csn);
+#endif
+	}
+	// }}}
+
+	// Called once for every new frame, before it is written anywhere
+	void	new_frame(void) {}
+
+	void	tick(void) {
+		// {{{
+		if (this->m_done)
+			return;
+
+		TESTB<VA, TB>::tick();
+
+		if (tb()->video().nframes() != m_last_frame) {
+			m_last_frame = tb()->video().nframes();
+			tb()->new_frame();
+			this->m_tracewin.frame(m_last_frame);
+			m_out.frame(m_last_frame, tb()->video().pixels());
+		}
+
+		if (tb()->video().nframes() > m_maxframes)
+			this->m_done = true;
+	}
+	// }}}
+
+	// passed()
+	// {{{
+	// Reports (to fp, if not NULL) on every checker that has fired, and
+	// returns true if none have
+	bool	passed(FILE *fp = stdout) {
+		bool	pass = true;
+
+		if (m_micnco.m_bomb) {
+			if (fp)
+				fprintf(fp, "FAIL: The A/D's SPI port was misused\n");
+			pass = false;
+		}
+
+		if (tb()->video().resyncs() > 0) {
+			if (fp)
+				fprintf(fp, "FAIL: Sync was lost during %lu frames\n",
+					tb()->video().resyncs());
+			pass = false;
+		}
+
+		if (!m_out.passed(fp))
+			pass = false;
+
+		if (m_sb.active() && !m_sb.report(fp)) {
+			if (fp)
+				fprintf(fp, "FAIL: The design doesn't match its models\n");
+			pass = false;
+		}
+
+		return pass;
+	}
+	// }}}
+
+	// Checkpoint support
+	// {{{
+	// Anything between the A/D and the video, such as a memory
+	void	save_devices(FILE *fp) {}
+	bool	restore_devices(FILE *fp) { return true; }
+
+	void	save_state(FILE *fp) {
+		TESTB<VA, TB>::save_state(fp);
+		fwrite(&m_adc_clocks, sizeof(m_adc_clocks), 1, fp);
+		m_micnco.save(fp);
+		tb()->save_devices(fp);
+		tb()->video().save(fp);
+	}
+
+	bool	restore_state(FILE *fp) {
+		if (!TESTB<VA, TB>::restore_state(fp))
+			return false;
+		if (fread(&m_adc_clocks, sizeof(m_adc_clocks), 1, fp) != 1)
+			return false;
+		if (!m_micnco.restore(fp)
+			|| !tb()->restore_devices(fp)
+			|| !tb()->video().restore(fp))
+			return false;
+		m_last_frame = tb()->video().nframes();
+		this->m_tracewin.frame(m_last_frame);
+		return true;
+	}
+	// }}}
+
+	bool	on_tick(void) {
+		// {{{
+		for(int i=0; i<32 && !this->m_done; i++)
+			tb()->tick();
+#ifndef	HEADLESS
+		// Closing the window returns from Gtk::Main::run()
+		if (this->m_done)
+			tb()->video().hide();
+#endif
+		return !this->m_done;
+	}
+	// }}}
+};
+// }}}
+
+#if	defined(SWEEP)
+// The parameter sweep
+// {{{
+#define	MAX_SWEEP	64
+
+// One simulation within the sweep, and what came of it.  The memory's
+// latency, and how it did, only apply to test benches with a memory.
+typedef	struct	SWEEPJOB_S {
+	const char	*m_stim;
+	int		m_cmap;
+	unsigned	m_delay;
+
+	bool		m_ok;
+	unsigned long	m_frames, m_ticks;
+	double		m_elapsed, m_stalls, m_latency;
+} SWEEPJOB;
+
+typedef	struct	SWEEPSET_S {
+	SWEEPJOB	*m_job;
+	bool		m_memory,	// Sweep the memory's latency too
+			m_ddr3;		// Model DDR3 timing
+	unsigned long	m_maxframes;
+	const char	*m_outdir;
+} SWEEPSET;
+
+static	void	sweep_usage(const char *progname, bool memory) {
+	// {{{
+	fprintf(stderr,
+"USAGE: %s [-%sh] [-c <colormap>]... [-i <stimulus>]... [-j <threads>]\n"
+"\t\t%s[-n <nframes>] [-o <dir>]\n"
+"\n"
+"\tRuns one simulation for every combination of the stimuli%s\n"
+"\tgiven, several at once, each in a thread of its own, and reports on\n"
+"\teach when done.  Exits with a non-zero status if any fail.\n"
+"\n"
+"\t-c <colormap>\tAdds a colormap, bw, mid, mmr, lin, or gt, to the\n"
+"\t\tsweep (default: gt)\n", progname, (memory) ? "d" : "",
+		(memory) ? "[-l <latency>]... " : "",
+		(memory) ? ", colormaps and memory latencies"
+			: " and colormaps");
+	if (memory) fprintf(stderr,
+"\t-d\tModels the timing of the DDR3 SDRAM in every simulation\n");
+	fprintf(stderr,
+"\t-h\tDisplays this usage statement\n"
+"\t-i <stimulus>\tAdds <stimulus> to the sweep.  See %s -h\n"
+"\t\tfor the stimuli that may be given.  (default: chirp)\n"
+"\t-j <threads>\tRuns up to <threads> simulations at once (default:\n"
+"\t\tone per processor)\n",
+		(memory) ? "ddr_headless" : "main_headless");
+	if (memory) fprintf(stderr,
+"\t-l <latency>\tAdds a memory latency, in clocks, to the sweep\n"
+"\t\t(default: 27)\n");
+	fprintf(stderr,
+"\t-n <nframes>\tRuns each simulation for <nframes> frames (default: 180)\n"
+"\t-o <dir>\tWrites every frame of simulation N to <dir>/jobNNN/\n");
+}
+// }}}
+
+// sweep_job()
+// {{{
+// Runs one simulation of the sweep.  TB::sweep_create() builds its test
+// bench, and TB::sweep_stats() adds anything else it can report on.
+template <class TB>	void	sweep_job(void *arg, int k) {
+	SWEEPSET	*sw  = (SWEEPSET *)arg;
+	SWEEPJOB	*job = &sw->m_job[k];
+	TB		*tb;
+	STIMULUS	*stim;
+	char		outdir[512];
+	struct timespec	tstart, tstop;
+
+	job->m_ok = false;
+	stim = make_stimulus(job->m_stim);
+	if (!stim)
+		return;
+
+	tb = TB::sweep_create(*sw, *job);
+	tb->m_maxframes = sw->m_maxframes;
+	tb->m_core->i_cmap = job->m_cmap;
+	tb->m_micnco.stimulus(stim);
+	if (sw->m_outdir) {
+		snprintf(outdir, sizeof(outdir), "%s/job%03d", sw->m_outdir, k);
+		if (mkdir(outdir, 0755) != 0 && errno != EEXIST)
+			perror("O/S Err:");
+		else {
+			tb->m_out.m_outdir = outdir;
+			tb->m_out.m_width  = tb->video().width();
+			tb->m_out.m_height = tb->video().height();
+		}
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &tstart);
+	tb->reset();
+	while(!tb->m_done)
+		tb->tick();
+	clock_gettime(CLOCK_MONOTONIC, &tstop);
+
+	job->m_elapsed = (tstop.tv_sec - tstart.tv_sec)
+			+ (tstop.tv_nsec - tstart.tv_nsec) * 1e-9;
+	job->m_frames  = tb->video().nframes();
+	job->m_ticks   = tb->m_clk.ticks();
+	tb->sweep_stats(*job);
+	job->m_ok = tb->passed(NULL);
+
+	delete tb;
+	delete stim;
+}
+// }}}
+
+// sweep()
+// {{{
+// The main() of every sweep (main_sweep, ddr_sweep).  With memory, the
+// memory latency (-l) and timing (-d) may be swept as well.
+template <class TB>	int	sweep(const char *progname, bool memory,
+				int argc, char **argv) {
+	SWEEPSET	sw;
+	const char	*stims[MAX_SWEEP];
+	int		cmaps[MAX_SWEEP];
+	unsigned	delays[MAX_SWEEP];
+	int		nstims = 0, ncmaps = 0, ndelays = 0, njobs,
+			nthreads = nprocessors(), opt, fails = 0;
+	struct timespec	tstart, tstop;
+	double		elapsed, ticks = 0;
+
+	sw.m_memory    = memory;
+	sw.m_ddr3      = false;
+	sw.m_maxframes = 180;
+	sw.m_outdir    = NULL;
+
+	while((opt = getopt(argc, argv,
+			(memory) ? "c:dhi:j:l:n:o:" : "c:hi:j:n:o:")) != -1) {
+		switch(opt) {
+		case 'c':
+			if (ncmaps >= MAX_SWEEP)
+				break;
+			cmaps[ncmaps] = SCENARIO::colormap(optarg);
+			if (cmaps[ncmaps++] < 0) {
+				fprintf(stderr, "ERR: Unknown colormap, %s\n", optarg);
+				exit(EXIT_FAILURE);
+			}
+			break;
+		case 'd': sw.m_ddr3 = true; break;
+		case 'h': sweep_usage(progname, memory); exit(EXIT_SUCCESS); break;
+		case 'i':
+			if (nstims < MAX_SWEEP)
+				stims[nstims++] = optarg;
+			break;
+		case 'j': nthreads = atoi(optarg); break;
+		case 'l':
+			if (ndelays < MAX_SWEEP)
+				delays[ndelays++] = strtoul(optarg, NULL, 0);
+			break;
+		case 'n': sw.m_maxframes = strtoul(optarg, NULL, 0); break;
+		case 'o': sw.m_outdir = optarg; break;
+		default:
+			sweep_usage(progname, memory);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (nstims == 0)
+		stims[nstims++] = "chirp";
+	if (ncmaps == 0)
+		cmaps[ncmaps++] = 4;
+	if (ndelays == 0)
+		delays[ndelays++] = 27;
+
+	// Check every stimulus up front, rather than have each job fail
+	for(int k=0; k<nstims; k++) {
+		STIMULUS	*s = make_stimulus(stims[k]);
+
+		if (!s)
+			exit(EXIT_FAILURE);
+		delete s;
+	}
+
+	if (sw.m_outdir && mkdir(sw.m_outdir, 0755) != 0 && errno != EEXIST) {
+		fprintf(stderr, "ERR: Cannot create %s\n", sw.m_outdir);
+		perror("O/S Err:");
+		exit(EXIT_FAILURE);
+	}
+
+#ifndef	ROOT_VERILATOR
+	// Without a VerilatedContext per model, models can't run in parallel
+	if (nthreads > 1)
+		fprintf(stderr, "WARNING: This Verilator can only run one model at a time\n");
+	nthreads = 1;
+#endif
+
+	njobs = nstims * ncmaps * ndelays;
+	sw.m_job = new SWEEPJOB[njobs];
+	for(int k=0; k<njobs; k++) {
+		sw.m_job[k].m_stim  = stims[k / (ncmaps * ndelays)];
+		sw.m_job[k].m_cmap  = cmaps[(k / ndelays) % ncmaps];
+		sw.m_job[k].m_delay = delays[k % ndelays];
+		sw.m_job[k].m_stalls  = 0;
+		sw.m_job[k].m_latency = 0;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &tstart);
+	run_pool(njobs, nthreads, sweep_job<TB>, &sw);
+	clock_gettime(CLOCK_MONOTONIC, &tstop);
+	elapsed = (tstop.tv_sec - tstart.tv_sec)
+			+ (tstop.tv_nsec - tstart.tv_nsec) * 1e-9;
+
+	if (memory)
+		printf("%4s %-32s %4s %7s %6s %8s %8s %7s %8s %s\n", "Job",
+			"Stimulus", "Cmap", "Latency", "Frames", "Time(s)",
+			"MHz", "Stalls", "Rd Lat", "Result");
+	else
+		printf("%4s %-32s %4s %6s %8s %8s %s\n", "Job", "Stimulus",
+			"Cmap", "Frames", "Time(s)", "MHz", "Result");
+	for(int k=0; k<njobs; k++) {
+		SWEEPJOB	*job = &sw.m_job[k];
+		double		mhz = (job->m_elapsed > 0)
+				? job->m_ticks / job->m_elapsed / 1e6 : 0;
+
+		if (memory)
+			printf("%4d %-32s %4s %7u %6lu %8.3f %8.3f %6.2f%% %8.2f %s\n",
+				k, job->m_stim,
+				SCENARIO::colormap_name(job->m_cmap),
+				job->m_delay, job->m_frames, job->m_elapsed,
+				mhz, 100.0 * job->m_stalls, job->m_latency,
+				(job->m_ok) ? "PASS" : "FAIL");
+		else
+			printf("%4d %-32s %4s %6lu %8.3f %8.3f %s\n",
+				k, job->m_stim,
+				SCENARIO::colormap_name(job->m_cmap),
+				job->m_frames, job->m_elapsed, mhz,
+				(job->m_ok) ? "PASS" : "FAIL");
+		ticks += job->m_ticks;
+		if (!job->m_ok)
+			fails++;
+	}
+
+	printf("%d simulations on %d threads in %.3f s: %.3f MHz simulated clock, in all\n",
+		njobs, (nthreads < njobs) ? nthreads : njobs, elapsed,
+		ticks / elapsed / 1e6);
+
+	delete[] sw.m_job;
+	return (fails) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+// }}}
+// }}}
+#else
+// A single simulation, from the command line and any scenario files
+// {{{
+
+// bench_usage()
+// {{{
+// The usage statement of every test bench but the sweeps.  video is the
+// kind of video the design produces, VGA or HDMI.  With memory, the options
+// for the memory model (-d, -l, -m, -s) are described too.
+static	void	bench_usage(const char *progname, const char *video,
+			bool memory) {
+	fprintf(stderr,
+"USAGE: %s [-%shC] [-c <colormap>] [-f <file>] [-g <dir> [-P <dB>]]\n"
+"\t\t[-H <file>] [-i <stimulus>] %s[-n <nframes>]\n"
+"\t\t[-o <dir>] [-p <file>] [-r <file>] %s[-S <name>]\n"
+"\t\t[-t <file> [-T <window>]] [-v <file>] [-w <file>]\n"
+"\n", progname, (memory) ? "d" : "",
+		(memory) ? "[-l <latency>] [-m <file>] " : "",
+		(memory) ? "[-s <file>] " : "");
+	fprintf(stderr,
+#ifdef	HEADLESS
+"\tRuns the simulation without a GUI, as fast as it can go, and reports\n"
+"\tthe number of simulated frames per (wall-clock) second when done.\n"
+#else
+"\tRuns the simulation, displaying the %s output in a window.\n"
+#endif
+"\tExits with a non-zero status if the A/D's SPI port is misused, if\n"
+"\tthe %s decoder loses sync after the first frame, if any frame\n"
+"\tdoesn't match its golden counterpart (-g), or if the design doesn't\n"
+"\tmatch its models (-C).\n"
+"\n"
+"\t-c <colormap>\tDisplays using one of the colormaps bw, mid, mmr,\n"
+"\t\tlin, or gt (default: gt)\n"
+"\t-C\tChecks the filter, window, FFT, and log stages of the design\n"
+"\t\tagainst bit exact C++ models, in a thread of their own, as the\n"
+"\t\tsimulation runs.  Any mismatch is reported by stage, frame,\n"
+"\t\tand bin.  May not be used with -r.  make check-rtl runs both\n"
+"\t\ttest benches this way.\n",
+#ifndef	HEADLESS
+		video,
+#endif
+		video);
+	if (memory) fprintf(stderr,
+"\t-d\tModels the timing of the DDR3 SDRAM, rather than acknowledging\n"
+"\t\tevery request a fixed number of clocks after it is made\n");
+	fprintf(stderr,
+"\t-f <file>\tReads settings from the scenario file <file>.  (See\n"
+"\t\tscenario.h.)  Each option given after -f overrides the file.\n"
+"\t-g <dir>\tCompares every frame against <dir>/frameNNNNN.ppm, as\n"
+"\t\twritten by -o from a prior run, reporting the number of pixels\n"
+"\t\tthat differ, where, and the PSNR\n"
+"\t-h\tDisplays this usage statement\n"
+"\t-H <file>\tWrites a 64-bit hash of every frame to <file>.  Two\n"
+"\t\truns producing the same video will produce the same hashes.\n"
+"\t-i <stimulus>\tFeeds <stimulus> to the microphone, rather than the\n"
+"\t\tdefault chirp.  <stimulus> may be any of\n"
+"\t\t\tchirp[:<start hz>:<hz per second>]\n"
+"\t\t\ttone:<hz>[:<amplitude>]\n"
+"\t\t\tnoise:<amplitude>[:<seed>]\n"
+"\t\t\timpulse:<period>[:<amplitude>]\n"
+"\t\t\tfile:<16-bit PCM or WAV file>[:<sample rate>]\n"
+"\t\tor several of these joined by '+'.  Amplitudes are fractions\n"
+"\t\tof full scale.\n");
+	if (memory) fprintf(stderr,
+"\t-l <latency>\tAcknowledges memory requests <latency> clocks after\n"
+"\t\tthey are made (default: 27)\n"
+"\t-m <file>\tLogs every memory request to <file>, for memreplay\n");
+	fprintf(stderr,
+"\t-n <nframes>\tStops once <nframes> frames have been received\n"
+"\t\t(default: 180).  This includes any frames received before the\n"
+"\t\tsnapshot given to -r was taken.\n"
+"\t-o <dir>\tWrites every decoded frame to <dir>/frameNNNNN.ppm, and\n"
+"\t\tthe settings used to <dir>/scenario\n"
+"\t-p <file>\tProbes a handful of signals within the design on every\n"
+"\t\tclock, and writes the last %d changes to them to <file> when\n"
+"\t\tdone.  The file will be CSV if its name ends in .csv, binary\n"
+"\t\t(see probes.h) otherwise.\n"
+"\t-P <dB>\tAllows frames to differ from their golden counterparts,\n"
+"\t\tso long as the PSNR is at least <dB>\n"
+"\t-r <file>\tRestores the simulation from the snapshot <file> before\n"
+"\t\tstarting, rather than starting from reset\n", PROBE_DEPTH);
+	if (memory) fprintf(stderr,
+"\t-s <file>\tWrites memory bus statistics to <file> when done, or\n"
+"\t\twhenever a SIGUSR1 is received.  The file will be JSON if its\n"
+"\t\tname ends in .json, CSV otherwise.\n");
+	fprintf(stderr,
+"\t-S <name>\tPublishes every frame, as it is decoded, into the POSIX\n"
+"\t\tshared memory ring <name> (e.g. /fftdemo), for shmview to show\n"
+"\t-t <file>\tTraces the design into <file>.  The trace is an FST file\n"
+"\t\tif the test bench was built with TRACE_FST (main_fst, ddr_fst),\n"
+"\t\tVCD otherwise.\n"
+"\t-T <window>\tTraces only the window described by <window>, a\n"
+"\t\tcomma separated list of any of\n"
+"\t\t\tframe=<n>,clock=<n>\tStart no sooner than frame (clock) <n>\n"
+"\t\t\ton=[!]<signal>\tThen start on the next edge of <signal>\n"
+"\t\t\tfor=<time>,clocks=<n>\tStop after <time> (<n> clocks)\n"
+"\t\t\toff=[!]<signal>\tOr stop on the next edge of <signal>\n"
+"\t\t\tpre=<time>\tAlso keep at least <time> before the start\n"
+"\t\t\tflush=<time>\tHow often to flush the trace (default: 1ms)\n"
+"\t\tTimes are in ps, unless followed by ns, us, ms, or s.  For\n"
+"\t\texample, frame=150,on=fft_sync,for=2ms.  Any pre-trigger\n"
+"\t\thistory is kept in <file>-pre.  Any of the one bit signals\n"
+"\t\tprobed by -p may be used.\n"
+"\t-v <file>\tStreams every frame, as it is decoded, to <file>: Y4M if\n"
+"\t\t<file> ends in .y4m, raw 24-bit RGB otherwise.  <file> may be a\n"
+"\t\tnamed pipe, or - for stdout.  Prefixing y4m: or rgb: to <file>\n"
+"\t\toverrides its extension.\n"
+"\t-w <file>\tWrites a snapshot of the simulation to <file> when done\n");
+}
+// }}}
+
+// bench_scenario()
+// {{{
+// Collects the settings for this run from the command line, and from any
+// scenario files named there.  The memory options are only accepted with
+// memory.
+static	bool	bench_scenario(SCENARIO &sc, const char *progname,
+			const char *video, bool memory, int argc, char **argv) {
+	int	opt;
+	bool	ok = true;
+
+	while(ok && (opt = getopt(argc, argv, (memory)
+			? "c:Cdf:g:hH:i:l:m:n:o:p:P:r:s:S:t:T:v:w:"
+			: "c:Cf:g:hH:i:n:o:p:P:r:S:t:T:v:w:")) != -1) {
+		switch(opt) {
+		case 'c': ok = sc.set("colormap", optarg); break;
+		case 'C': ok = sc.set("scoreboard", "1"); break;
+		case 'd': ok = sc.set("ddr3", "1"); break;
+		case 'f': ok = sc.load(optarg); break;
+		case 'g': ok = sc.set("golden", optarg); break;
+		case 'h': bench_usage(progname, video, memory);
+			exit(EXIT_SUCCESS); break;
+		case 'H': ok = sc.set("hashes", optarg); break;
+		case 'i': ok = sc.set("stimulus", optarg); break;
+		case 'l': ok = sc.set("latency", optarg); break;
+		case 'm': ok = sc.set("memlog", optarg); break;
+		case 'n': ok = sc.set("frames", optarg); break;
+		case 'o': ok = sc.set("outdir", optarg); break;
+		case 'p': ok = sc.set("probes", optarg); break;
+		case 'P': ok = sc.set("psnr", optarg); break;
+		case 'r': ok = sc.set("restore", optarg); break;
+		case 'S': ok = sc.set("shm", optarg); break;
+		case 's': ok = sc.set("stats", optarg); break;
+		case 't': ok = sc.set("trace", optarg); break;
+		case 'T': ok = sc.set("window", optarg); break;
+		case 'v': ok = sc.set("stream", optarg); break;
+		case 'w': ok = sc.set("save", optarg); break;
+		default:
+			bench_usage(progname, video, memory);
+			ok = false;
+		}
+	}
+
+	return ok;
+}
+// }}}
+
+// bench_start()
+// {{{
+// Applies the settings of a scenario to a new test bench, and starts it,
+// either from reset or from a snapshot.  The stimulus, if not NULL, is
+// still owned by the caller.
+template <class TB>	bool	bench_start(TB *tb, const SCENARIO &sc,
+				STIMULUS *stim) {
+	tb->m_maxframes = sc.m_frames;
+	if (!tb->m_out.open(sc, tb->video().width(), tb->video().height()))
+		return false;
+	if (stim)
+		tb->m_micnco.stimulus(stim);
+	if (sc.m_restore) {
+		if (!tb->restore(sc.m_restore))
+			return false;
+	} else
+		tb->reset();
+	if (sc.m_scoreboard) {
+		// The models start from reset, and so must the design
+		if (sc.m_restore) {
+			fprintf(stderr, "ERR: The scoreboard (-C) can't start from a snapshot\n");
+			return false;
+		}
+		if (!tb->scoreboard())
+			return false;
+	}
+	// After any snapshot, so that the colormap may be changed from the
+	// one the snapshot was taken with
+	tb->m_core->i_cmap = sc.m_colormap;
+	if (sc.m_trace && !tb->tracewindow(sc.m_trace, sc.m_window))
+		return false;
+	if (sc.m_probes)
+		tb->m_probes.arm(0, PROBE_DEPTH, true);
+	return true;
+}
+// }}}
+
+// bench_speed()
+// {{{
+// Reports how fast a headless simulation ran
+template <class TB>	void	bench_speed(TB *tb, unsigned long frame0,
+			unsigned long ticks0, const struct timespec &tstart) {
+	struct timespec	tstop;
+	double		elapsed;
+
+	clock_gettime(CLOCK_MONOTONIC, &tstop);
+	elapsed = (tstop.tv_sec - tstart.tv_sec)
+			+ (tstop.tv_nsec - tstart.tv_nsec) * 1e-9;
+	printf("%lu frames in %.3f s: %.3f frames/s, %.3f MHz simulated clock\n",
+		tb->video().nframes() - frame0, elapsed,
+		(tb->video().nframes() - frame0) / elapsed,
+		(tb->m_clk.ticks() - ticks0) / elapsed / 1e6);
+}
+// }}}
+
+// bench_finish()
+// {{{
+// Writes out anything the scenario asked for once done, and returns true if
+// every checker passed
+template <class TB>	bool	bench_finish(TB *tb, const SCENARIO &sc) {
+	if (sc.m_probes && !tb->m_probes.dump(sc.m_probes))
+		return false;
+
+	if (sc.m_save && !tb->save(sc.m_save))
+		return false;
+
+	tb->m_out.close();
+	return tb->passed();
+}
+// }}}
+// }}}
+#endif
+#endif
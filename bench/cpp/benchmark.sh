@@ -0,0 +1,104 @@
+#!/bin/bash
+################################################################################
+##
+## Filename:	bench/cpp/benchmark.sh
+## {{{
+## Project:	FFT-DEMO, a verilator-based spectrogram display project
+##
+## Purpose:	Runs each of the headless test benches for the same number of
+##		frames, and reports how fast each one ran: frames per second,
+##	and simulated (system) clock ticks per second.  The single threaded
+##	headless builds are run first, then each of the multithreaded builds
+##	(main_mt<N>, ddr_mt<N>) for each thread count N given, and then any
+##	other builds named by -x (main_<x>, ddr_<x>).  Each is also compared
+##	against the single threaded headless build.
+##
+##	Usage: benchmark.sh [-n <nframes>] [-t "<thread counts>"]
+##			[-x "<other builds>"]
+##
+## Creator:	Dan Gisselquist, Ph.D.
+##		Gisselquist Technology, LLC
+##
+################################################################################
+## }}}
+## Copyright (C) 2015-2024, Gisselquist Technology, LLC
+## {{{
+## This program is free software (firmware): you can redistribute it and/or
+## modify it under the terms of the GNU General Public License as published
+## by the Free Software Foundation, either version 3 of the License, or (at
+## your option) any later version.
+##
+## This program is distributed in the hope that it will be useful, but WITHOUT
+## ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+## FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+## for more details.
+##
+## You should have received a copy of the GNU General Public License along
+## with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+## target there if the PDF file isn't present.)  If not, see
+## <http://www.gnu.org/licenses/> for a copy.
+## }}}
+## License:	GPL, v3, as defined and found on www.gnu.org,
+## {{{
+##		http://www.gnu.org/licenses/gpl.html
+##
+################################################################################
+##
+## }}}
+NFRAMES=20
+THREADS="1 2 4"
+EXTRA=""
+
+while getopts "n:t:x:" opt
+do
+  case $opt in
+    n) NFRAMES=$OPTARG ;;
+    t) THREADS=$OPTARG ;;
+    x) EXTRA=$OPTARG ;;
+    *) echo "Usage: $0 [-n <nframes>] [-t \"<thread counts>\"] [-x \"<other builds>\"]" >&2
+       exit 1 ;;
+  esac
+done
+
+## run <program> <threads>
+## {{{
+## Runs one test bench, and prints one line of the table from the summary
+## line it prints when done:
+##	<N> frames in <T> s: <F> frames/s, <M> MHz simulated clock
+## The simulated rate of the first test bench run for each design is kept in
+## BASEHZ, to compare the others against.
+run() {
+  if [[ ! -x ./$1 ]];
+  then
+    printf "%-16s %7s  (not built)\n" $1 $2
+    return
+  fi
+
+  LINE=`./$1 -n $NFRAMES 2>/dev/null | grep "MHz simulated clock"`
+  HZ=`echo $LINE | awk '{ printf("%.0f", $8 * 1e6); }'`
+  if [[ -z $BASEHZ ]];
+  then
+    BASEHZ=$HZ
+  fi
+
+  echo $LINE | awk -v prog=$1 -v nt=$2 -v base=$BASEHZ \
+      '{ printf("%-16s %7s %10.3f %14.0f %7.2fx\n", prog, nt, $6,
+		$8 * 1e6, ($8 * 1e6) / base); }'
+}
+## }}}
+
+printf "%-16s %7s %10s %14s %8s\n" "Test bench" "Threads" "Frames/s" \
+	"Simulated Hz" "Speedup"
+for design in main ddr
+do
+  BASEHZ=""
+  run ${design}_headless "-"
+  for n in $THREADS
+  do
+    run ${design}_mt$n $n
+  done
+  for x in $EXTRA
+  do
+    run ${design}_$x "-"
+  done
+done
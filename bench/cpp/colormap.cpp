@@ -0,0 +1,270 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/colormap.cpp
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	The 256 entry color tables of rtl/bwmap.v, midmap.v, mmrmap.v,
+//		linmap.v, and gtmap.v.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#include "colormap.h"
+
+// Transcribed from the rtbl[], gtbl[] and btbl[] initial blocks of each map.
+// None of the maps initialize entry 255, which Verilator (--x-initial fast)
+// then leaves as zero.  So it is here: 255 is black in every map.
+const	unsigned	colormap_tbl[NCOLORMAPS][256] = {
+	{ // bw, from rtl/bwmap.v
+		0x000000, 0x000000, 0x010101, 0x020202, 0x030303, 0x040404,
+		0x050505, 0x060606, 0x070707, 0x080808, 0x090909, 0x0a0a0a,
+		0x0b0b0b, 0x0c0c0c, 0x0d0d0d, 0x0e0e0e, 0x0f0f0f, 0x101010,
+		0x111111, 0x121212, 0x131313, 0x141414, 0x151515, 0x161616,
+		0x171717, 0x181818, 0x191919, 0x1a1a1a, 0x1b1b1b, 0x1c1c1c,
+		0x1d1d1d, 0x1e1e1e, 0x1f1f1f, 0x202020, 0x212121, 0x222222,
+		0x232323, 0x242424, 0x252525, 0x262626, 0x272727, 0x282828,
+		0x292929, 0x2a2a2a, 0x2b2b2b, 0x2c2c2c, 0x2d2d2d, 0x2e2e2e,
+		0x2f2f2f, 0x303030, 0x313131, 0x323232, 0x333333, 0x343434,
+		0x353535, 0x363636, 0x373737, 0x383838, 0x393939, 0x3a3a3a,
+		0x3b3b3b, 0x3c3c3c, 0x3d3d3d, 0x3e3e3e, 0x3f3f3f, 0x404040,
+		0x414141, 0x424242, 0x434343, 0x444444, 0x454545, 0x464646,
+		0x474747, 0x484848, 0x494949, 0x4a4a4a, 0x4b4b4b, 0x4c4c4c,
+		0x4d4d4d, 0x4e4e4e, 0x4f4f4f, 0x505050, 0x515151, 0x525252,
+		0x535353, 0x545454, 0x555555, 0x565656, 0x575757, 0x585858,
+		0x595959, 0x5a5a5a, 0x5b5b5b, 0x5c5c5c, 0x5d5d5d, 0x5e5e5e,
+		0x5f5f5f, 0x606060, 0x616161, 0x626262, 0x636363, 0x646464,
+		0x656565, 0x666666, 0x676767, 0x686868, 0x696969, 0x6a6a6a,
+		0x6b6b6b, 0x6c6c6c, 0x6d6d6d, 0x6e6e6e, 0x6f6f6f, 0x707070,
+		0x717171, 0x727272, 0x737373, 0x747474, 0x757575, 0x767676,
+		0x777777, 0x787878, 0x797979, 0x7a7a7a, 0x7b7b7b, 0x7c7c7c,
+		0x7d7d7d, 0x7e7e7e, 0x7f7f7f, 0x808080, 0x818181, 0x828282,
+		0x838383, 0x848484, 0x858585, 0x868686, 0x878787, 0x888888,
+		0x898989, 0x8a8a8a, 0x8b8b8b, 0x8c8c8c, 0x8d8d8d, 0x8e8e8e,
+		0x8f8f8f, 0x909090, 0x919191, 0x929292, 0x939393, 0x949494,
+		0x959595, 0x969696, 0x979797, 0x989898, 0x999999, 0x9a9a9a,
+		0x9b9b9b, 0x9c9c9c, 0x9d9d9d, 0x9e9e9e, 0x9f9f9f, 0xa0a0a0,
+		0xa1a1a1, 0xa2a2a2, 0xa3a3a3, 0xa4a4a4, 0xa5a5a5, 0xa6a6a6,
+		0xa7a7a7, 0xa8a8a8, 0xa9a9a9, 0xaaaaaa, 0xababab, 0xacacac,
+		0xadadad, 0xaeaeae, 0xafafaf, 0xb0b0b0, 0xb1b1b1, 0xb2b2b2,
+		0xb3b3b3, 0xb4b4b4, 0xb5b5b5, 0xb6b6b6, 0xb7b7b7, 0xb8b8b8,
+		0xb9b9b9, 0xbababa, 0xbbbbbb, 0xbcbcbc, 0xbdbdbd, 0xbebebe,
+		0xbfbfbf, 0xc0c0c0, 0xc1c1c1, 0xc2c2c2, 0xc3c3c3, 0xc4c4c4,
+		0xc5c5c5, 0xc6c6c6, 0xc7c7c7, 0xc8c8c8, 0xc9c9c9, 0xcacaca,
+		0xcbcbcb, 0xcccccc, 0xcdcdcd, 0xcecece, 0xcfcfcf, 0xd0d0d0,
+		0xd1d1d1, 0xd2d2d2, 0xd3d3d3, 0xd4d4d4, 0xd5d5d5, 0xd6d6d6,
+		0xd7d7d7, 0xd8d8d8, 0xd9d9d9, 0xdadada, 0xdbdbdb, 0xdcdcdc,
+		0xdddddd, 0xdedede, 0xdfdfdf, 0xe0e0e0, 0xe1e1e1, 0xe2e2e2,
+		0xe3e3e3, 0xe4e4e4, 0xe5e5e5, 0xe6e6e6, 0xe7e7e7, 0xe8e8e8,
+		0xe9e9e9, 0xeaeaea, 0xebebeb, 0xececec, 0xededed, 0xeeeeee,
+		0xefefef, 0xf0f0f0, 0xf1f1f1, 0xf2f2f2, 0xf3f3f3, 0xf4f4f4,
+		0xf5f5f5, 0xf6f6f6, 0xf7f7f7, 0xf8f8f8, 0xf9f9f9, 0xfafafa,
+		0xfbfbfb, 0xfcfcfc, 0xfdfdfd, 0x000000
+	},
+	{ // mid, from rtl/midmap.v
+		0x000026, 0x000029, 0x00002d, 0x000030, 0x000034, 0x000037,
+		0x00003b, 0x00003e, 0x000042, 0x000045, 0x000049, 0x00004c,
+		0x000050, 0x000053, 0x000057, 0x00005a, 0x00005e, 0x000061,
+		0x000065, 0x000068, 0x00006c, 0x00006f, 0x000073, 0x000076,
+		0x00007a, 0x00007d, 0x000180, 0x000481, 0x000782, 0x000a84,
+		0x000d85, 0x001086, 0x001387, 0x001688, 0x001989, 0x001d8b,
+		0x00208c, 0x00238d, 0x00268e, 0x00298f, 0x002c91, 0x002f92,
+		0x003293, 0x003594, 0x003895, 0x003c97, 0x003f98, 0x004299,
+		0x00459a, 0x00489b, 0x004b9d, 0x004e9e, 0x00519f, 0x0054a0,
+		0x0057a1, 0x005aa2, 0x005ea4, 0x0061a5, 0x0064a6, 0x0067a7,
+		0x006aa8, 0x006daa, 0x0070ab, 0x0073ac, 0x0076ad, 0x0079ae,
+		0x007db0, 0x0080b1, 0x0083b2, 0x0086b3, 0x0089b4, 0x008cb6,
+		0x008fb7, 0x0092b8, 0x0095b9, 0x0098ba, 0x009bbb, 0x009fbd,
+		0x00a2be, 0x00a5bf, 0x00a7bd, 0x00a8b9, 0x00a9b5, 0x00aab1,
+		0x00abad, 0x00aca9, 0x00ada5, 0x00aea1, 0x00af9d, 0x00b099,
+		0x00b195, 0x00b292, 0x00b38e, 0x00b48a, 0x00b586, 0x00b682,
+		0x00b77e, 0x00b87a, 0x00ba76, 0x00bb72, 0x00bc6e, 0x00bd6a,
+		0x00be66, 0x00bf62, 0x00c05e, 0x00c15a, 0x00c256, 0x00c352,
+		0x00c44e, 0x00c54a, 0x00c647, 0x00c743, 0x00c83f, 0x00c93b,
+		0x00ca37, 0x00cb33, 0x00cc2f, 0x00ce2b, 0x00cf27, 0x00d023,
+		0x00d11f, 0x00d21b, 0x00d317, 0x00d413, 0x00d50f, 0x00d60b,
+		0x00d707, 0x00d803, 0x00d900, 0x03d900, 0x07d900, 0x0bd800,
+		0x0ed800, 0x12d800, 0x16d800, 0x1ad700, 0x1dd700, 0x21d700,
+		0x25d700, 0x29d600, 0x2cd600, 0x30d600, 0x34d600, 0x38d500,
+		0x3bd500, 0x3fd500, 0x43d500, 0x47d400, 0x4ad400, 0x4ed400,
+		0x52d400, 0x56d300, 0x59d300, 0x5dd300, 0x61d300, 0x65d200,
+		0x68d200, 0x6cd200, 0x70d200, 0x74d100, 0x77d100, 0x7bd100,
+		0x7fd100, 0x83d000, 0x86d000, 0x8ad000, 0x8ed000, 0x92cf00,
+		0x95cf00, 0x99cf00, 0x9dcf00, 0xa1ce00, 0xa4ce00, 0xa8ce00,
+		0xacce00, 0xb0cd00, 0xb3cd00, 0xb7cd00, 0xbbcd00, 0xbfcc00,
+		0xc1cb00, 0xc3ca00, 0xc5c800, 0xc7c600, 0xc9c500, 0xcbc300,
+		0xcdc200, 0xcec000, 0xd0bf00, 0xd2bd00, 0xd4bc00, 0xd6ba00,
+		0xd8b900, 0xdab700, 0xdcb600, 0xdeb400, 0xe0b200, 0xe2b100,
+		0xe4af00, 0xe6ae00, 0xe7ac00, 0xe9ab00, 0xeba900, 0xeda800,
+		0xefa600, 0xf1a500, 0xf3a300, 0xf5a200, 0xf7a000, 0xf99e00,
+		0xfb9d00, 0xfd9b00, 0xff9a00, 0xff9700, 0xff9400, 0xff9000,
+		0xff8d00, 0xff8900, 0xff8600, 0xff8200, 0xff7f00, 0xff7b00,
+		0xff7700, 0xff7400, 0xff7000, 0xff6d00, 0xff6900, 0xff6600,
+		0xff6200, 0xff5f00, 0xff5b00, 0xff5800, 0xff5400, 0xff5100,
+		0xff4d00, 0xff4a00, 0xff4600, 0xff4300, 0xff3f00, 0xff3b00,
+		0xff3800, 0xff3400, 0xff3100, 0xff2d00, 0xff2a00, 0xff2600,
+		0xff2300, 0xff1f00, 0xff1c00, 0xff1800, 0xff1500, 0xff1100,
+		0xff0e00, 0xff0a00, 0xff0700, 0x000000
+	},
+	{ // mmr, from rtl/mmrmap.v
+		0x000000, 0x000000, 0x010100, 0x020200, 0x030300, 0x040400,
+		0x050500, 0x060600, 0x070700, 0x080800, 0x090900, 0x0a0a00,
+		0x0b0b00, 0x0c0c00, 0x0d0d00, 0x0e0e00, 0x0f0f00, 0x101001,
+		0x111101, 0x121201, 0x131301, 0x141401, 0x151501, 0x161602,
+		0x171702, 0x181802, 0x191902, 0x1a1a02, 0x1b1b03, 0x1c1c03,
+		0x1d1d03, 0x1e1e03, 0x1f1f03, 0x202004, 0x212104, 0x222204,
+		0x232305, 0x242405, 0x252505, 0x262605, 0x272706, 0x282806,
+		0x292906, 0x2a2a07, 0x2b2b07, 0x2c2c07, 0x2d2d08, 0x2e2e08,
+		0x2f2f08, 0x303009, 0x313109, 0x32320a, 0x33330a, 0x34340a,
+		0x35350b, 0x36360b, 0x37370c, 0x38380c, 0x39390d, 0x3a3a0d,
+		0x3b3b0e, 0x3c3c0e, 0x3d3d0f, 0x3e3e0f, 0x3f3f0f, 0x404010,
+		0x414111, 0x424211, 0x434312, 0x444412, 0x454513, 0x464613,
+		0x474714, 0x484814, 0x494915, 0x4a4a15, 0x4b4b16, 0x4c4c17,
+		0x4d4d17, 0x4e4e18, 0x4f4f18, 0x505019, 0x51511a, 0x52521a,
+		0x53531b, 0x54541c, 0x55551c, 0x56561d, 0x57571e, 0x58581e,
+		0x59591f, 0x5a5a20, 0x5b5b21, 0x5c5c21, 0x5d5d22, 0x5e5e23,
+		0x5f5f23, 0x606024, 0x616125, 0x626226, 0x636327, 0x646427,
+		0x656528, 0x666629, 0x67672a, 0x68682b, 0x69692b, 0x6a6a2c,
+		0x6b6b2d, 0x6c6c2e, 0x6d6d2f, 0x6e6e30, 0x6f6f30, 0x707031,
+		0x717132, 0x727233, 0x737334, 0x747435, 0x757536, 0x767637,
+		0x777738, 0x787839, 0x79793a, 0x7a7a3b, 0x7b7b3c, 0x7c7c3d,
+		0x7d7d3e, 0x7e7e3f, 0x7f7f3f, 0x808041, 0x818142, 0x828243,
+		0x838344, 0x848445, 0x858546, 0x868647, 0x878748, 0x888849,
+		0x89894a, 0x8a8a4b, 0x8b8b4c, 0x8c8c4d, 0x8d8d4e, 0x8e8e4f,
+		0x8f8f50, 0x909052, 0x919153, 0x929254, 0x939355, 0x949456,
+		0x959557, 0x969659, 0x97975a, 0x98985b, 0x99995c, 0x9a9a5d,
+		0x9b9b5f, 0x9c9c60, 0x9d9d61, 0x9e9e62, 0x9f9f63, 0xa0a065,
+		0xa1a166, 0xa2a267, 0xa3a369, 0xa4a46a, 0xa5a56b, 0xa6a66c,
+		0xa7a76e, 0xa8a86f, 0xa9a970, 0xaaaa72, 0xabab73, 0xacac74,
+		0xadad76, 0xaeae77, 0xafaf78, 0xb0b07a, 0xb1b17b, 0xb2b27d,
+		0xb3b37e, 0xb4b47f, 0xb5b581, 0xb6b682, 0xb7b784, 0xb8b885,
+		0xb9b987, 0xbaba88, 0xbbbb8a, 0xbcbc8b, 0xbdbd8d, 0xbebe8e,
+		0xbfbf8f, 0xc0c091, 0xc1c193, 0xc2c294, 0xc3c396, 0xc4c497,
+		0xc5c599, 0xc6c69a, 0xc7c79c, 0xc8c89d, 0xc9c99f, 0xcacaa0,
+		0xcbcba2, 0xcccca4, 0xcdcda5, 0xcecea7, 0xcfcfa8, 0xd0d0aa,
+		0xd1d1ac, 0xd2d2ad, 0xd3d3af, 0xd4d4b1, 0xd5d5b2, 0xd6d6b4,
+		0xd7d7b6, 0xd8d8b7, 0xd9d9b9, 0xdadabb, 0xdbdbbd, 0xdcdcbe,
+		0xddddc0, 0xdedec2, 0xdfdfc3, 0xe0e0c5, 0xe1e1c7, 0xe2e2c9,
+		0xe3e3cb, 0xe4e4cc, 0xe5e5ce, 0xe6e6d0, 0xe7e7d2, 0xe8e8d4,
+		0xe9e9d5, 0xeaead7, 0xebebd9, 0xececdb, 0xededdd, 0xeeeedf,
+		0xefefe0, 0xf0f0e2, 0xf1f1e4, 0xf2f2e6, 0xf3f3e8, 0xf4f4ea,
+		0xf5f5ec, 0xf6f6ee, 0xf7f7f0, 0xf8f8f2, 0xf9f9f4, 0xfafaf6,
+		0xfbfbf8, 0xfcfcfa, 0xfdfdfc, 0x000000
+	},
+	{ // lin, from rtl/linmap.v
+		0x000000, 0x000000, 0x000100, 0x000200, 0x000300, 0x000400,
+		0x000500, 0x000601, 0x000701, 0x000801, 0x000902, 0x000a02,
+		0x000b03, 0x000c04, 0x000d04, 0x000d05, 0x000e06, 0x000f06,
+		0x001007, 0x001008, 0x001109, 0x00120a, 0x00120b, 0x00130c,
+		0x00130d, 0x00140e, 0x00140f, 0x001510, 0x001511, 0x001512,
+		0x001614, 0x001615, 0x001616, 0x001617, 0x001619, 0x00161a,
+		0x00161b, 0x00161d, 0x00161e, 0x00161f, 0x001621, 0x001522,
+		0x001524, 0x001525, 0x001426, 0x001428, 0x001329, 0x00132a,
+		0x00122c, 0x00112d, 0x00102f, 0x000f30, 0x000f31, 0x000e33,
+		0x000d34, 0x000c35, 0x000a36, 0x000938, 0x000839, 0x00073a,
+		0x00053b, 0x00043c, 0x00033d, 0x00013e, 0x00003f, 0x010040,
+		0x030041, 0x040042, 0x060043, 0x080044, 0x0a0045, 0x0c0045,
+		0x0e0046, 0x0f0047, 0x110047, 0x140048, 0x160048, 0x180049,
+		0x1a0049, 0x1c0049, 0x1e0049, 0x20004a, 0x23004a, 0x25004a,
+		0x27004a, 0x290049, 0x2c0049, 0x2e0049, 0x300049, 0x330048,
+		0x350048, 0x370047, 0x3a0047, 0x3c0046, 0x3f0045, 0x410044,
+		0x430043, 0x460042, 0x480041, 0x4a0040, 0x4d003f, 0x4f003e,
+		0x51003c, 0x54003b, 0x560039, 0x580038, 0x5a0036, 0x5d0034,
+		0x5f0032, 0x610031, 0x63002f, 0x65002c, 0x67002a, 0x690028,
+		0x6b0026, 0x6d0024, 0x6f0021, 0x70001f, 0x72001c, 0x74001a,
+		0x750017, 0x770014, 0x780011, 0x7a000f, 0x7b000c, 0x7c0009,
+		0x7d0006, 0x7e0003, 0x7f0000, 0x800300, 0x810600, 0x820900,
+		0x830c00, 0x841000, 0x851300, 0x861700, 0x871a00, 0x881e00,
+		0x892100, 0x8a2500, 0x8b2800, 0x8c2c00, 0x8d2f00, 0x8e3300,
+		0x8f3700, 0x903a00, 0x913e00, 0x924200, 0x934500, 0x944900,
+		0x954d00, 0x965000, 0x975400, 0x985800, 0x995b00, 0x9a5f00,
+		0x9b6200, 0x9c6600, 0x9d6a00, 0x9e6d00, 0x9f7100, 0xa07400,
+		0xa17800, 0xa27b00, 0xa37e00, 0xa48200, 0xa58500, 0xa68800,
+		0xa78b00, 0xa88e00, 0xa99100, 0xaa9400, 0xab9700, 0xac9a00,
+		0xad9d00, 0xae9f00, 0xafa200, 0xb0a500, 0xb1a700, 0xb2a900,
+		0xb3ac00, 0xb4ae00, 0xb5b000, 0xb6b200, 0xb7b400, 0xb8b600,
+		0xb9b700, 0xbab900, 0xbbbb00, 0xbcbc00, 0xbdbd00, 0xbebe00,
+		0xbfbf00, 0xc0c004, 0xc1c109, 0xc2c20e, 0xc3c313, 0xc4c418,
+		0xc5c51d, 0xc6c622, 0xc7c727, 0xc8c82c, 0xc9c931, 0xcaca36,
+		0xcbcb3b, 0xcccc40, 0xcdcd45, 0xcece4a, 0xcfcf4f, 0xd0d054,
+		0xd1d159, 0xd2d25e, 0xd3d363, 0xd4d468, 0xd5d56e, 0xd6d673,
+		0xd7d778, 0xd8d87c, 0xd9d981, 0xdada86, 0xdbdb8b, 0xdcdc90,
+		0xdddd95, 0xdede99, 0xdfdf9e, 0xe0e0a2, 0xe1e1a7, 0xe2e2ab,
+		0xe3e3b0, 0xe4e4b4, 0xe5e5b8, 0xe6e6bc, 0xe7e7c0, 0xe8e8c4,
+		0xe9e9c8, 0xeaeacc, 0xebebd0, 0xececd3, 0xededd7, 0xeeeeda,
+		0xefefdd, 0xf0f0e0, 0xf1f1e3, 0xf2f2e6, 0xf3f3e9, 0xf4f4ec,
+		0xf5f5ee, 0xf6f6f0, 0xf7f7f3, 0xf8f8f5, 0xf9f9f7, 0xfafaf9,
+		0xfbfbfa, 0xfcfcfc, 0xfdfdfd, 0x000000
+	},
+	{ // gt, from rtl/gtmap.v
+		0x000000, 0x000000, 0x000000, 0x000001, 0x000002, 0x000003,
+		0x000005, 0x010007, 0x010009, 0x01000c, 0x02000f, 0x020012,
+		0x030015, 0x030019, 0x04001d, 0x040021, 0x050025, 0x06002a,
+		0x06002e, 0x070033, 0x080038, 0x09003e, 0x0a0043, 0x0b0049,
+		0x0c004f, 0x0d0054, 0x0e005a, 0x0f0060, 0x100067, 0x11006d,
+		0x130073, 0x140079, 0x15007f, 0x160086, 0x18008c, 0x190092,
+		0x1b0098, 0x1c009f, 0x1e00a5, 0x1f00ab, 0x2100b0, 0x2200b6,
+		0x2400bc, 0x2600c1, 0x2700c7, 0x2900cc, 0x2b00d1, 0x2c00d5,
+		0x2e00da, 0x3000de, 0x3200e2, 0x3400e6, 0x3600ea, 0x3800ed,
+		0x3a00f0, 0x3c00f3, 0x3e00f6, 0x4000f8, 0x4200fa, 0x4400fc,
+		0x4600fd, 0x4800fe, 0x4a00ff, 0x4c00ff, 0x4f00ff, 0x5100ff,
+		0x5300ff, 0x5500fe, 0x5700fd, 0x5a00fc, 0x5c00fa, 0x5e00f8,
+		0x6000f6, 0x6300f3, 0x6500f0, 0x6700ed, 0x6a00ea, 0x6c00e6,
+		0x6e00e2, 0x7100de, 0x7300da, 0x7500d5, 0x7800d1, 0x7a00cc,
+		0x7c00c7, 0x7f00c1, 0x8100bc, 0x8300b6, 0x8600b0, 0x8800ab,
+		0x8a00a5, 0x8d009f, 0x8f0098, 0x920192, 0x94018c, 0x960286,
+		0x98027f, 0x9b0279, 0x9d0373, 0x9f046d, 0xa20467, 0xa40560,
+		0xa6055a, 0xa80654, 0xab074f, 0xad0849, 0xaf0943, 0xb10a3e,
+		0xb30a38, 0xb60b33, 0xb80c2e, 0xba0e2a, 0xbc0f25, 0xbe1021,
+		0xc0111d, 0xc21219, 0xc41315, 0xc61512, 0xc8160f, 0xca170c,
+		0xcc1909, 0xce1a07, 0xcf1c05, 0xd11d03, 0xd31f02, 0xd52001,
+		0xd72200, 0xd82300, 0xda2500, 0xdc2700, 0xdd2800, 0xdf2a00,
+		0xe02c00, 0xe22e00, 0xe33000, 0xe53100, 0xe63300, 0xe83500,
+		0xe93700, 0xea3900, 0xec3b00, 0xed3d00, 0xee3f00, 0xef4100,
+		0xf04300, 0xf14500, 0xf34700, 0xf44900, 0xf54c00, 0xf54e00,
+		0xf65000, 0xf75200, 0xf85400, 0xf95700, 0xfa5900, 0xfa5b00,
+		0xfb5d00, 0xfb6000, 0xfc6200, 0xfd6400, 0xfd6700, 0xfd6900,
+		0xfe6b00, 0xfe6d00, 0xff7000, 0xff7200, 0xff7500, 0xff7700,
+		0xff7900, 0xff7c00, 0xff7e00, 0xff8000, 0xff8300, 0xff8500,
+		0xff8700, 0xff8a01, 0xff8c02, 0xff8e03, 0xff9104, 0xff9305,
+		0xff9507, 0xff9809, 0xff9a0a, 0xff9c0c, 0xff9f0f, 0xffa111,
+		0xffa313, 0xffa516, 0xffa819, 0xffaa1c, 0xffac1f, 0xffae22,
+		0xffb025, 0xffb328, 0xffb52c, 0xffb730, 0xffb933, 0xffbb37,
+		0xffbd3b, 0xffbf3f, 0xffc143, 0xffc347, 0xffc54c, 0xffc750,
+		0xffc954, 0xffcb59, 0xffcd5d, 0xffcf62, 0xffd167, 0xffd36b,
+		0xffd470, 0xffd675, 0xffd879, 0xffd97e, 0xffdb83, 0xffdd87,
+		0xffde8c, 0xffe091, 0xffe195, 0xffe39a, 0xffe49f, 0xffe6a3,
+		0xffe7a8, 0xffe9ac, 0xffeab0, 0xffebb5, 0xffecb9, 0xffeebd,
+		0xffefc1, 0xfff0c5, 0xfff1c9, 0xfff2cd, 0xfff3d1, 0xfff4d4,
+		0xfff5d8, 0xfff6db, 0xfff7de, 0xfff8e1, 0xfff9e4, 0xfff9e7,
+		0xfffaea, 0xfffbec, 0xfffbef, 0xfffcf1, 0xfffcf3, 0xfffdf5,
+		0xfffdf7, 0xfffef9, 0xfffefa, 0xfffefb, 0xfffffc, 0xfffffd,
+		0xfffffe, 0xffffff, 0xffffff, 0x000000
+	}
+};
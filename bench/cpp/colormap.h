@@ -0,0 +1,59 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/colormap.h
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	The colormaps of rtl/colormap.v, as tables of 0x00RRGGBB colors
+//		(the same format the video decoders use), so that a model of
+//	the design may color its pixels just as the design itself would.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#ifndef	COLORMAP_H
+#define	COLORMAP_H
+
+// The number of colormaps, and the 0x00RRGGBB color each gives to each of the
+// 256 pixel values, in the order rtl/colormap.v selects them by i_cmap
+static	const	int	NCOLORMAPS = 5;
+extern	const	unsigned	colormap_tbl[NCOLORMAPS][256];
+
+// colormap()
+// {{{
+// Returns the color rtl/colormap.v gives to pixel under map cmap.  As in the
+// RTL, any map past the last is the last (gt).
+static inline	unsigned	colormap(int cmap, unsigned pixel) {
+	if (cmap < 0 || cmap >= NCOLORMAPS)
+		cmap = NCOLORMAPS-1;
+	return colormap_tbl[cmap][pixel & 0x0ff];
+}
+// }}}
+
+#endif
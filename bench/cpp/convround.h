@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/convround.h
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	The rounding used throughout the FFT, modeled in C++ for the bit
+//		exact models of windowfn (windowfn.h) and fftmain (fftmain.h).
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#ifndef	CONVROUND_H
+#define	CONVROUND_H
+
+#include <stdint.h>
+
+// Sign extends the low w bits of v
+static inline	int64_t	sext(int64_t v, int w) {
+	return (int64_t)((uint64_t)v << (64-w)) >> (64-w);
+}
+
+// convround()
+// {{{
+// Rounds the iwid bit value v to owid bits, after dropping its top shift
+// bits, exactly as rtl/fft/convround.v would.  Ties round to even.  Any
+// bits dropped from the top are simply lost, so the result wraps rather
+// than saturating, just like the RTL's.
+static inline	int64_t	convround(int64_t v, int iwid, int owid,
+				int shift) {
+	int	drop = iwid - shift - owid;	// Bits lost from the bottom
+
+	if (iwid == owid)
+		return sext(v, owid);
+	else if (drop < 0)
+		return sext(v, iwid - shift);
+	else if (drop == 0)
+		return sext(v, owid);
+
+	// Adding half-1, plus the last bit kept, carries into the bits kept
+	// for anything over half, and for exactly half when that bit is odd
+	return sext((v + ((int64_t)1 << (drop-1)) - 1 + ((v >> drop) & 1))
+			>> drop, owid);
+}
+// }}}
+
+#endif
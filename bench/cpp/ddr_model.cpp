@@ -0,0 +1,169 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/ddr_model.cpp
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	A test bench for the models of the design, rather than the design
+//		itself.  The A/D, filter, window, FFT, and log stages are
+//	strung together (see specmodel.h), together with the memory writer,
+//	the memory, and the frame reader, to produce the frames ddr_headless
+//	would produce from the same scenario, in a fraction of the time.
+//	This makes it possible to see what minutes of video will look like,
+//	or to produce golden frames for ddr_tb -g, without Verilator.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "specmodel.h"
+#include "scenario.h"
+#include "frameout.h"
+
+static	const	int	W = SPECMODEL::WIDTH, H = SPECMODEL::HEIGHT;
+
+void	usage(void) {
+	// {{{
+	fprintf(stderr,
+"USAGE: ddr_model [-bh] [-c <colormap>] [-f <file>] [-g <dir> [-P <dB>]]\n"
+"\t\t[-H <file>] [-i <stimulus>] [-l <latency>] [-n <nframes>]\n"
+"\t\t[-o <dir>] [-S <name>] [-v <file>]\n"
+"\n"
+"\tProduces the same frames ddr_headless would, from C++ models of the\n"
+"\tdesign rather than the design itself, many times faster.  The models\n"
+"\tof each stage are bit exact, and so is their timing: where the\n"
+"\tdisplay catches the memory mid-update, the model counts the clocks\n"
+"\tto each write and each line read from the RTL (see specmodel.h).\n"
+"\tThe frames should match ddr_headless's pixel for pixel, as\n"
+"\tmake check-ddr confirms.  Use -g to compare against any others.\n"
+"\n"
+"\tThe options are those of ddr_headless, save for the following:\n"
+"\n"
+"\t-b\tModels the timing of ddr_bypass, where the A/D samples are\n"
+"\t\tgiven directly to the design, rather than over its SPI port\n"
+"\t-h\tDisplays this usage statement\n"
+"\n"
+"\tThe memory is modeled with a fixed latency (-l), never as DDR3\n"
+"\t(-d).  There is nothing to trace, probe, check (-C), or snapshot.\n");
+}
+// }}}
+
+// scenario()
+// {{{
+bool	scenario(SCENARIO &sc, bool &bypass, int argc, char **argv) {
+	int	opt;
+	bool	ok = true;
+
+	while(ok && (opt = getopt(argc, argv, "bc:f:g:hH:i:l:n:o:P:S:v:")) != -1) {
+		switch(opt) {
+		case 'b': bypass = true; break;
+		case 'c': ok = sc.set("colormap", optarg); break;
+		case 'f': ok = sc.load(optarg); break;
+		case 'g': ok = sc.set("golden", optarg); break;
+		case 'h': usage(); exit(EXIT_SUCCESS); break;
+		case 'H': ok = sc.set("hashes", optarg); break;
+		case 'i': ok = sc.set("stimulus", optarg); break;
+		case 'l': ok = sc.set("latency", optarg); break;
+		case 'n': ok = sc.set("frames", optarg); break;
+		case 'o': ok = sc.set("outdir", optarg); break;
+		case 'P': ok = sc.set("psnr", optarg); break;
+		case 'S': ok = sc.set("shm", optarg); break;
+		case 'v': ok = sc.set("stream", optarg); break;
+		default:
+			usage();
+			ok = false;
+		}
+	}
+
+	// A scenario file may ask for more than the model can give
+	if (ok && (sc.m_ddr3 || sc.m_scoreboard || sc.m_trace || sc.m_probes
+			|| sc.m_restore || sc.m_save || sc.m_memlog
+			|| sc.m_stats)) {
+		fprintf(stderr, "ERR: ddr_model can only model a fixed memory latency, and can't\n"
+			"\ttrace, probe, check, snapshot, or log its memory\n");
+		ok = false;
+	}
+
+	return ok;
+}
+// }}}
+
+int	main(int argc, char **argv) {
+	// {{{
+	SCENARIO	sc;
+	STIMULUS	*stim = NULL;
+	SPECMODEL	*model;
+	FRAMEOUT	out;
+	bool		bypass = false, pass;
+	struct timespec	tstart, tstop;
+	double		elapsed;
+
+	if (!scenario(sc, bypass, argc, argv))
+		exit(EXIT_FAILURE);
+
+	if (sc.m_stim && !(stim = make_stimulus(sc.m_stim)))
+		exit(EXIT_FAILURE);
+
+	if (!FRAMEOUT::mkoutdir(sc) || !out.open(sc, W, H))
+		exit(EXIT_FAILURE);
+
+	model = new SPECMODEL(bypass, sc.m_latency);
+	if (!model->load())
+		exit(EXIT_FAILURE);
+	if (stim)
+		model->stimulus(stim);
+	model->colormap(sc.m_colormap);
+
+	clock_gettime(CLOCK_MONOTONIC, &tstart);
+	// As with the test bench, the frame that finishes the run is kept
+	while(model->nframes() <= sc.m_frames) {
+		const unsigned	*px = model->frame();
+
+		out.frame(model->nframes(), px);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &tstop);
+
+	elapsed = (tstop.tv_sec - tstart.tv_sec)
+			+ (tstop.tv_nsec - tstart.tv_nsec) * 1e-9;
+	printf("%lu frames in %.3f s: %.3f frames/s, %.3f MHz simulated clock\n",
+		model->nframes(), elapsed, model->nframes() / elapsed,
+		model->clocks() / elapsed / 1e6);
+
+	out.close();
+	pass = out.passed();
+
+	delete model;
+	delete stim;
+	exit((pass) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+// }}}
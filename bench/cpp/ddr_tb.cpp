@@ -45,80 +45,74 @@
 //
 // }}}
 #include <signal.h>
-#include <time.h>
-#include <ctype.h>
-
-// #define	VL_THREADED
-// #define	TRACE_FST
 
 #include "verilated.h"
-#ifdef	TRACE_VCD
-#include "verilated_vcd_c.h"
-#endif
-#ifdef	TRACE_FST
-#include "verilated_fst_c.h"
-#endif
-
 #include "Vhdmiddr.h"
+#ifdef	ROOT_VERILATOR
+#include "Vhdmiddr___024root.h"
+#endif
 
-#include "testb.h"
 // #include "twoc.h"
+#ifdef	HEADLESS
+#include "hdmidec.h"
+#else
 #include "hdmisim.h"
-#include "vgasim.h"
-#include "micnco.h"
+#endif
 #include "memsim.h"
 
-#ifdef	NEW_VERILATOR
-#define	VVAR(A)	busmaster__DOT_ ## A
+#ifdef	ROOT_VERILATOR
+#define	VVAR(A)	rootp->hdmiddr__DOT_ ## A
+#elif	defined(NEW_VERILATOR)
+#define	VVAR(A)	hdmiddr__DOT_ ## A
 #else
 #define	VVAR(A)	v__DOT_ ## A
 #endif
 
+#include "benchmain.h"
+#include "specmodel.h"
 
 // No particular "parameters" need definition or redefinition here.
 #define	BASE	Vhdmiddr
 
-class	TESTBENCH : public TESTB<BASE> {
+class	TESTBENCH : public BENCHMAIN<BASE, TESTBENCH> {
 public:
 	unsigned long	m_tx_busy_count;
+#ifdef	HEADLESS
+	HDMIDEC		m_hdmi;
+#else
 	HDMIWIN		m_hdmi;
-	MICNCO		m_micnco;
+#endif
 	MEMSIM		m_ddr;
-	bool		m_done;
+	int		m_writer, m_reader;	// MEMSTATS source tags
 
-	TESTBENCH(void) : m_hdmi(800, 600), m_ddr((1<<25), 27) {
-		//
-		m_core->i_reset = 1;
-		//
-		m_done = false;
+	TESTBENCH(const DDR3TIMING *timing = NULL, unsigned delay = 27)
+			: m_hdmi(800, 600), m_ddr((1<<25), delay, timing) {
+		m_writer = m_ddr.m_stats.add_source("writer");
+		m_reader = m_ddr.m_stats.add_source("reader");
 
-		TESTB<BASE>::m_pixclk.set_frequency_hz(m_hdmi.clocks_per_frame() * 60);
-		Glib::signal_idle().connect(sigc::mem_fun((*this),
-				&TESTBENCH::on_tick));
-	}
-
-#ifdef	TRACE_VCD
-	void	tracevcd(const char *vcd_trace_file_name) {
-		fprintf(stderr, "Opening TRACE(%s)\n", vcd_trace_file_name);
-		openvcd(vcd_trace_file_name);
-	}
+		// Signals that may be probed, or traced upon
+		add_probes(21);
+		m_probes.add("o_sdram_cyc", &m_core->o_sdram_cyc);
+		m_probes.add("o_sdram_stb", &m_core->o_sdram_stb);
+		m_probes.add("o_sdram_we", &m_core->o_sdram_we);
+		m_probes.add("i_sdram_ack", &m_core->i_sdram_ack);
+		m_probes.add("i_sdram_stall", &m_core->i_sdram_stall);
+		m_probes.add("o_adc_csn", &m_core->o_adc_csn);
+#ifdef	ADC_BYPASS
+		m_probes.add("i_adc_ce", &m_core->i_adc_ce);
 #endif
 
-#ifdef	TRACE_FST
-	void	tracefst(const char *fst_trace_file_name) {
-		fprintf(stderr, "Opening TRACE(%s)\n", fst_trace_file_name);
-		openfst(fst_trace_file_name);
+		TESTB<BASE, TESTBENCH>::m_pixclk.set_frequency_hz(m_hdmi.clocks_per_frame() * 60);
 	}
-#endif
 
-	void	close(void) {
-		// TESTB<BASECLASS>::closetrace();
-		m_done = true;
-	}
+#ifdef	HEADLESS
+	HDMIDEC	&video(void) { return m_hdmi; }
+#else
+	HDMIWIN	&video(void) { return m_hdmi; }
+#endif
 
 	void	sim_clk_tick(void) {
-		m_core->i_adc_miso = m_micnco(m_core->o_adc_sck,
-					m_core->o_adc_csn);
+		BENCHMAIN<BASE, TESTBENCH>::sim_clk_tick();
 
 		m_ddr.apply(m_core->o_sdram_cyc,
 				m_core->o_sdram_stb,
@@ -128,7 +122,10 @@ public:
 				m_core->o_sdram_sel,
 				m_core->i_sdram_ack,
 				m_core->i_sdram_stall,
-				m_core->i_sdram_data);
+				m_core->i_sdram_data,
+				// Only wrdata writes to memory, and only
+				// hdmiframe reads from it
+				(m_core->o_sdram_we) ? m_writer : m_reader);
 	}
 
 	void	sim_pixclk_tick(void) {
@@ -136,37 +133,132 @@ public:
 			m_core->o_hdmi_red);
 	}
 
-	void	tick(void) {
-		if (m_done)
-			return;
+	void	new_frame(void) {
+		m_ddr.m_stats.frame();
+	}
 
-		TESTB<BASE>::tick();
+	// scoreboard()
+	// {{{
+	// Starts checking each stage of the design against its model, using
+	// the same filter SPECMODEL has for hdmiddr.v
+	bool	scoreboard(void) {
+		SUBFILDOWN	*fil = SPECMODEL::filter();
 
-		if (gbl_nframes > 180) {
-			exit(EXIT_SUCCESS);
-			m_done = true;
-		}
+		if (!fil)
+			return false;
+		return m_sb.start(m_probes, fil, SPECMODEL::WNDW_LSB);
 	}
+	// }}}
 
-	bool	on_tick(void) {
-		for(int i=0; i<32; i++)
-			tick();
-		return !m_done;
+	void	save_devices(FILE *fp) {
+		m_ddr.save(fp);
 	}
+
+	bool	restore_devices(FILE *fp) {
+		return m_ddr.restore(fp);
+	}
+
+#ifdef	SWEEP
+	static	TESTBENCH *sweep_create(const SWEEPSET &sw, const SWEEPJOB &job) {
+		return new TESTBENCH((sw.m_ddr3) ? &NEXYS_VIDEO_DDR3 : NULL,
+				job.m_delay);
+	}
+
+	void	sweep_stats(SWEEPJOB &job) {
+		MEMSTATS::SOURCE	*rd = &m_ddr.m_stats.m_src[m_reader];
+
+		job.m_stalls  = (m_ddr.m_stats.m_clocks)
+				? m_ddr.m_stats.m_stalls
+					/ (double)m_ddr.m_stats.m_clocks : 0;
+		job.m_latency = (rd->m_acks)
+				? rd->m_latency_sum / (double)rd->m_acks : 0;
+	}
+#endif
 };
 
-TESTBENCH	*tb;
+#if	defined(SWEEP)
+#define	PROGNAME	"ddr_sweep"
+#elif	defined(ADC_BYPASS)
+#define	PROGNAME	"ddr_bypass"
+#elif	defined(NO_TRACE)
+#define	PROGNAME	"ddr_mt"
+#elif	defined(TRACE_FST)
+#define	PROGNAME	"ddr_fst"
+#elif	defined(HEADLESS)
+#define	PROGNAME	"ddr_headless"
+#else
+#define	PROGNAME	"ddr_tb"
+#endif
+
+#ifdef	HEADLESS
+static	volatile sig_atomic_t	gbl_dump_stats = 0;
+
+void	sigusr1(int) {
+	gbl_dump_stats = 1;
+}
+#endif
 
 int	main(int argc, char **argv) {
+#if	defined(SWEEP)
+	exit(sweep<TESTBENCH>(PROGNAME, true, argc, argv));
+#else
+	// {{{
+	TESTBENCH	*tb;
+	SCENARIO	sc;
+	STIMULUS	*stim = NULL;
+	bool		pass;
+#ifdef	HEADLESS
+	struct timespec	tstart;
+	unsigned long	frame0, ticks0;
+#else
 	Gtk::Main	main_instance(argc, argv);
-	Verilated::commandArgs(argc, argv);
+#endif
+
+	if (!bench_scenario(sc, PROGNAME, "HDMI", true, argc, argv))
+		exit(EXIT_FAILURE);
 
-	tb = new TESTBENCH();
-	tb->reset();
+	if (sc.m_stim && !(stim = make_stimulus(sc.m_stim)))
+		exit(EXIT_FAILURE);
 
-	// tb->tracevcd("fftdemo.vcd");
+	if (!FRAMEOUT::mkoutdir(sc))
+		exit(EXIT_FAILURE);
+
+	tb = new TESTBENCH((sc.m_ddr3) ? &NEXYS_VIDEO_DDR3 : NULL,
+			sc.m_latency);
+	tb->commandArgs(argc, argv);
+	if (!bench_start(tb, sc, stim))
+		exit(EXIT_FAILURE);
+	if (sc.m_memlog && !tb->m_ddr.open_log(sc.m_memlog))
+		exit(EXIT_FAILURE);
+
+#ifdef	HEADLESS
+	frame0 = tb->m_hdmi.nframes();
+	ticks0 = tb->m_clk.ticks();
+
+	if (sc.m_stats)
+		signal(SIGUSR1, sigusr1);
+
+	clock_gettime(CLOCK_MONOTONIC, &tstart);
+	while(!tb->m_done) {
+		tb->tick();
+		if (gbl_dump_stats) {
+			gbl_dump_stats = 0;
+			tb->m_ddr.m_stats.dump(sc.m_stats);
+		}
+	}
+	bench_speed(tb, frame0, ticks0, tstart);
+	tb->m_ddr.report(stdout);
+#else
 	Gtk::Main::run(tb->m_hdmi);
+#endif
+	if (sc.m_stats && !tb->m_ddr.m_stats.dump(sc.m_stats))
+		exit(EXIT_FAILURE);
 
-	exit(0);
-}
+	pass = bench_finish(tb, sc);
 
+	delete tb;
+	delete stim;
+	exit((pass) ? EXIT_SUCCESS : EXIT_FAILURE);
+	// }}}
+#endif
+}
@@ -0,0 +1,333 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/fftmain.cpp
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	A bit exact model of rtl/fft/fftmain.v.  See fftmain.h.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef	__AVX2__
+#include <immintrin.h>
+#endif
+
+#include "readmemh.h"
+#include "convround.h"
+#include "fftmain.h"
+
+// The stages as fftmain.v instantiates them: input, coefficient and
+// output widths, log_2 of the span, and shift
+static	const	int	STAGES[FFTMAIN::NSTAGES][5] = {
+	{ 12, 14, 17, 9, 0 },	// stage_1024
+	{ 17, 19, 18, 8, 0 },	// stage_512
+	{ 18, 20, 18, 7, 0 },	// stage_256
+	{ 18, 20, 18, 6, 0 },	// stage_128
+	{ 18, 20, 18, 5, 0 },	// stage_64
+	{ 18, 20, 18, 4, 0 },	// stage_32
+	{ 18, 20, 18, 3, 0 },	// stage_16
+	{ 18, 20, 18, 2, 0 },	// stage_8
+	{ 18,  0, 18, 1, 0 },	// stage_4, a qtrstage
+	{ 18,  0, 16, 0, 1 }	// stage_2, the laststage
+};
+
+FFTMAIN::FFTMAIN(void) {
+	// {{{
+	for(int s=0; s<NSTAGES; s++) {
+		STAGE	&st = m_stage[s];
+
+		st.m_iw     = STAGES[s][0];
+		st.m_cw     = STAGES[s][1];
+		st.m_ow     = STAGES[s][2];
+		st.m_lgspan = STAGES[s][3];
+		st.m_shift  = STAGES[s][4];
+		if (st.m_cw > 0) {
+			st.m_cr = new int32_t[1<<st.m_lgspan]();
+			st.m_ci = new int32_t[1<<st.m_lgspan]();
+		} else
+			st.m_cr = st.m_ci = NULL;
+	}
+
+	m_re  = new int32_t[SIZE];
+	m_im  = new int32_t[SIZE];
+	m_in  = new unsigned[SIZE];
+	m_out = new unsigned[SIZE];
+
+	m_brev = new int[SIZE];
+	for(int k=0; k<SIZE; k++) {
+		m_brev[k] = 0;
+		for(int b=0; b<LGSIZE; b++)
+			if (k & (1<<b))
+				m_brev[k] |= 1 << (LGSIZE-1-b);
+	}
+
+	reset();
+}
+// }}}
+
+FFTMAIN::~FFTMAIN(void) {
+	// {{{
+	for(int s=0; s<NSTAGES; s++) {
+		delete[] m_stage[s].m_cr;
+		delete[] m_stage[s].m_ci;
+	}
+	delete[] m_re;
+	delete[] m_im;
+	delete[] m_in;
+	delete[] m_out;
+	delete[] m_brev;
+}
+// }}}
+
+bool	FFTMAIN::load(const char *dir) {
+	// {{{
+	for(int s=0; s<NSTAGES; s++) {
+		STAGE		&st = m_stage[s];
+		int		span = 1 << st.m_lgspan, n;
+		uint64_t	*v;
+		char		fname[512];
+
+		if (!st.m_cr)
+			continue;
+
+		snprintf(fname, sizeof(fname), "%s/cmem_%d.hex", dir, 2*span);
+		v = new uint64_t[span]();
+		if ((n = readmemh(fname, v, span)) < span) {
+			if (n >= 0)
+				fprintf(stderr, "ERR: %s holds %d twiddles, "
+					"not %d\n", fname, n, span);
+			delete[] v;
+			return false;
+		}
+
+		// Each twiddle is { real, imaginary }, CW bits each
+		for(int k=0; k<span; k++) {
+			st.m_cr[k] = (int32_t)sext(v[k] >> st.m_cw, st.m_cw);
+			st.m_ci[k] = (int32_t)sext(v[k], st.m_cw);
+		}
+		delete[] v;
+	}
+
+	return true;
+}
+// }}}
+
+#ifdef	__AVX2__
+// vload(), vstore(), vround()
+// {{{
+// Four 32-bit values to and from 64-bit lanes, and convround() of each
+// lane, where at least one bit is dropped.  Since only the low OW bits of
+// the shifted lane are kept, the shift needn't be arithmetic.
+static inline	__m256i	vload(const int32_t *p) {
+	return _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)p));
+}
+
+static inline	void	vstore(int32_t *p, __m256i v) {
+	const	__m256i	pack = _mm256_setr_epi32(0,2,4,6,0,0,0,0);
+
+	_mm_storeu_si128((__m128i *)p, _mm256_castsi256_si128(
+			_mm256_permutevar8x32_epi32(v, pack)));
+}
+
+static inline	__m256i	vround(__m256i v, __m256i half, __m128i drop,
+			__m256i omask, __m256i osign) {
+	const	__m256i	one = _mm256_set1_epi64x(1);
+	__m256i	r;
+
+	r = _mm256_add_epi64(_mm256_add_epi64(v, half),
+			_mm256_and_si256(_mm256_srl_epi64(v, drop), one));
+	r = _mm256_and_si256(_mm256_srl_epi64(r, drop), omask);
+	return _mm256_sub_epi64(_mm256_xor_si256(r, osign), osign);
+}
+// }}}
+#endif
+
+// hwbfly()
+// {{{
+// One fftstage: within every block of twice the span, sum each sample
+// with the one a span later, and multiply their difference by a twiddle.
+// The sum replaces the first, the product the second.  The widths and
+// roundings are those of rtl/fft/hwbfly.v.
+void	FFTMAIN::hwbfly(const STAGE &st) {
+	const	int	span = 1 << st.m_lgspan,
+			lw = st.m_cw + st.m_iw + 1,	// Left  (sum) width
+			rw = st.m_cw + st.m_iw + 3,	// Right (product) width
+			lsh = st.m_shift + 2, rsh = st.m_shift + 4;
+
+#ifdef	__AVX2__
+	// Four butterflies at a time, in 64-bit lanes.  Every operand of
+	// every product fits in 32-bits, so _mm256_mul_epi32 will do.
+	const	int	ldrop = lw - lsh - st.m_ow, rdrop = rw - rsh - st.m_ow;
+
+	if (span >= 4 && ldrop > 0 && rdrop > 0) {
+		const	__m256i	lhalf = _mm256_set1_epi64x((1l << (ldrop-1))-1),
+				rhalf = _mm256_set1_epi64x((1l << (rdrop-1))-1),
+				omask = _mm256_set1_epi64x((1l << st.m_ow)-1),
+				osign = _mm256_set1_epi64x(1l << (st.m_ow-1));
+		const	__m128i	ldv   = _mm_cvtsi32_si128(ldrop),
+				rdv   = _mm_cvtsi32_si128(rdrop),
+				csh   = _mm_cvtsi32_si128(st.m_cw - 2);
+
+		for(int b=0; b<SIZE; b+=2*span)
+		for(int n=0; n<span; n+=4) {
+			int32_t	*ar = &m_re[b+n], *ai = &m_im[b+n],
+				*br = ar + span, *bi = ai + span;
+			__m256i	xar = vload(ar), xai = vload(ai),
+				xbr = vload(br), xbi = vload(bi),
+				cr = vload(&st.m_cr[n]),
+				ci = vload(&st.m_ci[n]),
+				dr = _mm256_sub_epi64(xar, xbr),
+				di = _mm256_sub_epi64(xai, xbi),
+				sr = _mm256_sll_epi64(
+					_mm256_add_epi64(xar, xbr), csh),
+				si = _mm256_sll_epi64(
+					_mm256_add_epi64(xai, xbi), csh),
+				pr = _mm256_sub_epi64(_mm256_mul_epi32(cr, dr),
+					_mm256_mul_epi32(ci, di)),
+				pi = _mm256_add_epi64(_mm256_mul_epi32(cr, di),
+					_mm256_mul_epi32(ci, dr));
+
+			vstore(ar, vround(sr, lhalf, ldv, omask, osign));
+			vstore(ai, vround(si, lhalf, ldv, omask, osign));
+			vstore(br, vround(pr, rhalf, rdv, omask, osign));
+			vstore(bi, vround(pi, rhalf, rdv, omask, osign));
+		}
+		return;
+	}
+#endif
+
+	for(int b=0; b<SIZE; b+=2*span)
+	for(int n=0; n<span; n++) {
+		int64_t	ar = m_re[b+n], ai = m_im[b+n],
+			br = m_re[b+n+span], bi = m_im[b+n+span],
+			cr = st.m_cr[n], ci = st.m_ci[n],
+			dr = ar - br, di = ai - bi;
+
+		m_re[b+n] = (int32_t)convround((ar + br) << (st.m_cw-2),
+					lw, st.m_ow, lsh);
+		m_im[b+n] = (int32_t)convround((ai + bi) << (st.m_cw-2),
+					lw, st.m_ow, lsh);
+		m_re[b+n+span] = (int32_t)convround(cr * dr - ci * di,
+					rw, st.m_ow, rsh);
+		m_im[b+n+span] = (int32_t)convround(cr * di + ci * dr,
+					rw, st.m_ow, rsh);
+	}
+}
+// }}}
+
+// qtrstage()
+// {{{
+// The next to last stage, whose twiddles are 1 and -j.  The difference
+// is rounded before it is rotated, as in rtl/fft/qtrstage.v.
+void	FFTMAIN::qtrstage(const STAGE &st) {
+	const	int	w = st.m_iw + 1;
+
+	for(int b=0; b<SIZE; b+=4) {
+		for(int n=0; n<2; n++) {
+			int64_t	ar = m_re[b+n], ai = m_im[b+n],
+				br = m_re[b+n+2], bi = m_im[b+n+2],
+				dr, di;
+
+			m_re[b+n] = (int32_t)convround(ar + br, w, st.m_ow,
+						st.m_shift);
+			m_im[b+n] = (int32_t)convround(ai + bi, w, st.m_ow,
+						st.m_shift);
+			dr = convround(ar - br, w, st.m_ow, st.m_shift);
+			di = convround(ai - bi, w, st.m_ow, st.m_shift);
+			if (n == 0) {
+				m_re[b+n+2] = (int32_t)dr;
+				m_im[b+n+2] = (int32_t)di;
+			} else {
+				m_re[b+n+2] = (int32_t)di;
+				m_im[b+n+2] = (int32_t)sext(-dr, st.m_ow);
+			}
+		}
+	}
+}
+// }}}
+
+// laststage()
+// {{{
+// The final stage, whose twiddle is 1.  See rtl/fft/laststage.v
+void	FFTMAIN::laststage(const STAGE &st) {
+	const	int	w = st.m_iw + 1;
+
+	for(int b=0; b<SIZE; b+=2) {
+		int64_t	ar = m_re[b], ai = m_im[b],
+			br = m_re[b+1], bi = m_im[b+1];
+
+		m_re[b]   = (int32_t)convround(ar + br, w, st.m_ow, st.m_shift);
+		m_im[b]   = (int32_t)convround(ai + bi, w, st.m_ow, st.m_shift);
+		m_re[b+1] = (int32_t)convround(ar - br, w, st.m_ow, st.m_shift);
+		m_im[b+1] = (int32_t)convround(ai - bi, w, st.m_ow, st.m_shift);
+	}
+}
+// }}}
+
+void	FFTMAIN::transform(const unsigned *in, unsigned *out) {
+	// {{{
+	for(int k=0; k<SIZE; k++) {
+		m_re[k] = (int32_t)sext(in[k] >> IWIDTH, IWIDTH);
+		m_im[k] = (int32_t)sext(in[k], IWIDTH);
+	}
+
+	for(int s=0; s<NSTAGES; s++) {
+		if (m_stage[s].m_cr)
+			hwbfly(m_stage[s]);
+		else if (m_stage[s].m_lgspan == 1)
+			qtrstage(m_stage[s]);
+		else
+			laststage(m_stage[s]);
+	}
+
+	// The stages leave the results in bit reversed order.  Undo that,
+	// as rtl/fft/bitreverse.v does.
+	for(int k=0; k<SIZE; k++) {
+		int	j = m_brev[k];
+
+		out[k] = ((m_re[j] & 0x0ffff) << 16) | (m_im[j] & 0x0ffff);
+	}
+}
+// }}}
+
+const unsigned *FFTMAIN::operator()(unsigned sample) {
+	// {{{
+	m_in[m_nin++] = sample;
+	if (m_nin < (unsigned)SIZE)
+		return NULL;
+
+	m_nin = 0;
+	transform(m_in, m_out);
+	return m_out;
+}
+// }}}
@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/fftmain.h
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	A bit exact model of rtl/fft/fftmain.v, the 1024 point pipelined
+//		FFT generated by fftgen.  Given the same frame of samples, it
+//	produces the same frame of results as the RTL, in the same (natural)
+//	order--once the RTL's bit reversal is accounted for.
+//
+//	The RTL is a radix-2 decimation in frequency FFT, one stage per bit
+//	of the FFT's size.  Each stage butterflies those samples half a span
+//	apart, rounding (see convround.h) both the sum and the (twiddled)
+//	difference to the stage's output width.  The model does the same, a
+//	whole frame at a time, four butterflies at a time where AVX2 is
+//	available.  Frames are independent of each other, so the RTL's
+//	pipeline delay matters only in when the results come out, not what
+//	they are.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#ifndef	FFTMAIN_H
+#define	FFTMAIN_H
+
+#include <stdint.h>
+
+// FFTMAIN
+// {{{
+class	FFTMAIN {
+public:
+	static	const	int	LGSIZE = 10, SIZE = (1<<LGSIZE),
+				IWIDTH = 12, OWIDTH = 16,
+				NSTAGES = LGSIZE;
+
+	// One stage of the FFT.  The first LGSIZE-2 are fftstage's, with
+	// twiddle factors read from cmem_<2*span>.hex, then a qtrstage and
+	// finally a laststage.
+	typedef	struct	STAGE_S {
+		int	m_iw, m_cw, m_ow, m_lgspan, m_shift;
+		int32_t	*m_cr, *m_ci;	// Twiddles, if any
+	} STAGE;
+private:
+	STAGE		m_stage[NSTAGES];
+	int32_t		*m_re, *m_im;	// The frame, as it passes through
+	unsigned	*m_in, *m_out;	// A frame of RTL words in, and out
+	unsigned	m_nin;		// Samples in m_in so far
+	int		*m_brev;	// Bit reversed indices
+
+	void	hwbfly(const STAGE &st);
+	void	qtrstage(const STAGE &st);
+	void	laststage(const STAGE &st);
+public:
+	FFTMAIN(void);
+	~FFTMAIN(void);
+
+	// Reads the twiddle factors, cmem_8.hex through cmem_1024.hex, from
+	// the directory dir
+	bool	load(const char *dir = ".");
+
+	// Transforms one frame of SIZE samples, each packed as i_sample is,
+	// { real[11:0], imaginary[11:0] }, into SIZE results in natural
+	// order, each packed as o_result is, { real[15:0], imag[15:0] }
+	void	transform(const unsigned *in, unsigned *out);
+
+	// Returns to the state the RTL is in following a reset
+	void	reset(void) { m_nin = 0; }
+
+	// Accepts the next sample, as the RTL would on i_ce.  Once SIZE
+	// samples have been received, returns a pointer to the SIZE results
+	// the RTL will produce for them, otherwise NULL.  The pointer is good
+	// until the next frame is complete.
+	const unsigned	*operator()(unsigned sample);
+};
+// }}}
+
+#endif
@@ -0,0 +1,301 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/framediff.cpp
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Compares and hashes decoded frames.  See framediff.h.
+//
+//	The comparison uses SSE2, where available, to check four pixels at
+//	a time, and to find the squared error of any that differ.  Since most
+//	regressions change only a small part of the frame, if any, the rows
+//	that match are passed over quickly.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#ifdef	__SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "framediff.h"
+
+// rowdiff()
+// {{{
+// Returns the sum of squared errors across one row, and the number of
+// pixels within it that differ, leaving the first and last of them in
+// x0 and x1-1.
+static	uint64_t	rowdiff(const unsigned *a, const unsigned *b, int w,
+			unsigned long &npix, int &x0, int &x1) {
+	uint64_t	sse = 0;
+	int		x = 0;
+
+	npix = 0;
+	x0 = w; x1 = 0;
+#ifdef	__SSE2__
+	// Four pixels at a time.  A row of 8-bit errors can't overflow the
+	// 32-bit sums until rows get to be ~6k pixels wide, so sum the row
+	// in 32-bits, and then add it to the total
+	const	__m128i	zero = _mm_setzero_si128(),
+			rgb  = _mm_set1_epi32(0x0ffffff);
+	__m128i		acc = zero;
+
+	for(; x+4 <= w; x+=4) {
+		__m128i	va = _mm_and_si128(rgb,
+				_mm_loadu_si128((const __m128i *)&a[x])),
+			vb = _mm_and_si128(rgb,
+				_mm_loadu_si128((const __m128i *)&b[x])),
+			lo, hi;
+		int	same;
+
+		same = _mm_movemask_ps(_mm_castsi128_ps(
+					_mm_cmpeq_epi32(va, vb)));
+		if (same == 0x0f)
+			continue;
+
+		// The 8-bit differences, as 16-bit numbers, squared and
+		// summed in pairs
+		lo = _mm_sub_epi16(_mm_unpacklo_epi8(va, zero),
+					_mm_unpacklo_epi8(vb, zero));
+		hi = _mm_sub_epi16(_mm_unpackhi_epi8(va, zero),
+					_mm_unpackhi_epi8(vb, zero));
+		acc = _mm_add_epi32(acc, _mm_madd_epi16(lo, lo));
+		acc = _mm_add_epi32(acc, _mm_madd_epi16(hi, hi));
+
+		for(int k=0; k<4; k++) {
+			if (same & (1<<k))
+				continue;
+			npix++;
+			if (x+k < x0)
+				x0 = x+k;
+			x1 = x+k+1;
+		}
+	}
+
+	{
+		uint32_t	lanes[4];
+
+		_mm_storeu_si128((__m128i *)lanes, acc);
+		sse = (uint64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+	}
+#endif
+
+	// Whatever's left, one pixel at a time
+	for(; x<w; x++) {
+		unsigned	pa = a[x] & 0x0ffffff, pb = b[x] & 0x0ffffff;
+
+		if (pa == pb)
+			continue;
+		for(int s=0; s<24; s+=8) {
+			int	e = (int)((pa >> s) & 0x0ff)
+					- (int)((pb >> s) & 0x0ff);
+			sse += e * e;
+		}
+		npix++;
+		if (x < x0)
+			x0 = x;
+		x1 = x+1;
+	}
+
+	return sse;
+}
+// }}}
+
+void	framediff(const unsigned *a, const unsigned *b, int w, int h,
+		FRAMEDIFF &d) {
+	// {{{
+	d.m_pixels = 0;
+	d.m_sse    = 0;
+	d.m_x0 = w; d.m_y0 = h;
+	d.m_x1 = 0; d.m_y1 = 0;
+
+	for(int y=0; y<h; y++) {
+		unsigned long	npix;
+		int		x0, x1;
+
+		d.m_sse += rowdiff(&a[y*w], &b[y*w], w, npix, x0, x1);
+		if (npix == 0)
+			continue;
+
+		d.m_pixels += npix;
+		if (x0 < d.m_x0)
+			d.m_x0 = x0;
+		if (x1 > d.m_x1)
+			d.m_x1 = x1;
+		if (y < d.m_y0)
+			d.m_y0 = y;
+		d.m_y1 = y+1;
+	}
+
+	if (d.m_pixels == 0) {
+		d.m_x0 = d.m_y0 = 0;
+		d.m_psnr = HUGE_VAL;
+	} else {
+		double	mse = d.m_sse / (3.0 * w * h);
+
+		d.m_psnr = 10.0 * log10(255.0 * 255.0 / mse);
+	}
+}
+// }}}
+
+bool	writeppm(const char *fname, const unsigned *px, int w, int h) {
+	// {{{
+	FILE		*fp;
+	unsigned char	*line;
+	bool		r = true;
+
+	fp = fopen(fname, "wb");
+	if (!fp) {
+		fprintf(stderr, "ERR: Could not open %s for writing\n", fname);
+		perror("O/S Err:");
+		return false;
+	}
+
+	fprintf(fp, "P6\n%d %d\n255\n", w, h);
+
+	line = new unsigned char[3*w];
+	for(int y=0; y<h; y++) {
+		const unsigned	*row = &px[y*w];
+
+		for(int x=0; x<w; x++) {
+			line[3*x  ] = (row[x] >> 16) & 0x0ff;
+			line[3*x+1] = (row[x] >>  8) & 0x0ff;
+			line[3*x+2] = (row[x]      ) & 0x0ff;
+		}
+
+		if (fwrite(line, 3, w, fp) != (size_t)w)
+			r = false;
+	}
+
+	delete[] line;
+	if (fclose(fp) != 0)
+		r = false;
+
+	if (!r)
+		fprintf(stderr, "ERR: Could not write frame to %s\n", fname);
+	return r;
+}
+// }}}
+
+bool	readppm(const char *fname, unsigned *px, int w, int h) {
+	// {{{
+	FILE		*fp;
+	unsigned char	*line;
+	int		fw, fh, maxv;
+	bool		r = true;
+
+	fp = fopen(fname, "rb");
+	if (!fp) {
+		fprintf(stderr, "ERR: Could not open %s\n", fname);
+		return false;
+	}
+
+	if (fscanf(fp, "P6 %d %d %d", &fw, &fh, &maxv) != 3 || maxv != 255
+			|| fgetc(fp) == EOF) {
+		fprintf(stderr, "ERR: %s is not a (binary) PPM file\n", fname);
+		fclose(fp);
+		return false;
+	} else if (fw != w || fh != h) {
+		fprintf(stderr, "ERR: %s is %dx%d, not %dx%d\n", fname, fw, fh,
+			w, h);
+		fclose(fp);
+		return false;
+	}
+
+	// Unpack the file into the same 0x00RRGGBB format as VIDEODEC's
+	line = new unsigned char[3*w];
+	for(int y=0; y<h; y++) {
+		unsigned	*row = &px[y*w];
+
+		if (fread(line, 3, w, fp) != (size_t)w) {
+			fprintf(stderr, "ERR: %s is too short\n", fname);
+			r = false;
+			break;
+		}
+
+		for(int x=0; x<w; x++)
+			row[x] = (line[3*x] << 16) | (line[3*x+1] << 8)
+					| line[3*x+2];
+	}
+
+	delete[] line;
+	fclose(fp);
+	return r;
+}
+// }}}
+
+bool	diffppm(const char *fname, const unsigned *px, int w, int h,
+		FRAMEDIFF &d) {
+	// {{{
+	unsigned	*golden = new unsigned[w*h];
+	bool		r;
+
+	if ((r = readppm(fname, golden, w, h)))
+		framediff(px, golden, w, h, d);
+
+	delete[] golden;
+	return r;
+}
+// }}}
+
+unsigned long	framehash(const unsigned *px, size_t n) {
+	// {{{
+	// Four independent lanes, each a multiply-xorshift over two pixels at
+	// a time, so the multiplies needn't wait on each other
+	const	uint64_t	M = 0x9e3779b97f4a7c15ull;
+	uint64_t	h[4] = { 1, 2, 3, 4 }, r;
+	size_t		k = 0;
+
+	for(; k+8 <= n; k+=8) {
+		for(int j=0; j<4; j++) {
+			uint64_t	v = ((uint64_t)px[k+2*j+1] << 32)
+						| px[k+2*j];
+
+			h[j] = (h[j] ^ v) * M;
+			h[j] ^= h[j] >> 29;
+		}
+	}
+
+	for(; k<n; k++) {
+		h[0] = (h[0] ^ px[k]) * M;
+		h[0] ^= h[0] >> 29;
+	}
+
+	r = n;
+	for(int j=0; j<4; j++) {
+		r = (r ^ h[j]) * M;
+		r ^= r >> 32;
+	}
+
+	return (unsigned long)r;
+}
+// }}}
@@ -0,0 +1,81 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/framediff.h
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Checks decoded frames without anyone needing to look at them:
+//		a hash of each frame, to tell quickly whether two runs produced
+//	the same video, and a comparison against a golden frame, for when they
+//	didn't, giving the number of pixels that differ, where they are, and
+//	the PSNR.  Frames are kept between runs as PPM files, which are read
+//	and written here too.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#ifndef	FRAMEDIFF_H
+#define	FRAMEDIFF_H
+
+#include <stddef.h>
+
+// FRAMEDIFF
+// {{{
+// How one frame differs from another: how many pixels, where, and by how
+// much.  Pixels are 0x00RRGGBB, as decoded by VIDEODEC.
+typedef	struct	FRAMEDIFF_S {
+	unsigned long	m_pixels;	// Number of pixels that differ
+	int		m_x0, m_y0,	// Bounding box of those pixels,
+			m_x1, m_y1;	//   [x0,x1) x [y0,y1)
+	unsigned long	m_sse;		// Sum of squared (8-bit) errors
+	double		m_psnr;		// In dB, or HUGE_VAL if identical
+} FRAMEDIFF;
+// }}}
+
+// Compares two w x h frames, each stored a row at a time with no padding
+extern	void	framediff(const unsigned *a, const unsigned *b, int w, int h,
+			FRAMEDIFF &d);
+
+// Writes a w x h frame to a (binary, P6) PPM file
+extern	bool	writeppm(const char *fname, const unsigned *px, int w, int h);
+
+// Reads a w x h frame from a PPM file, as written by writeppm().  Returns
+// false, having said why, if the file can't be read or is some other size.
+extern	bool	readppm(const char *fname, unsigned *px, int w, int h);
+
+// Compares a w x h frame to the one in a PPM file.  Returns false if the file
+// can't be read, true (with the differences in d) otherwise.
+extern	bool	diffppm(const char *fname, const unsigned *px, int w, int h,
+			FRAMEDIFF &d);
+
+// A fast (non-cryptographic) 64-bit hash of n pixels.  Identical frames
+// hash identically, on any host.
+extern	unsigned long	framehash(const unsigned *px, size_t n);
+
+#endif
@@ -0,0 +1,151 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/frameout.cpp
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Everything done with a frame once it's been produced, whether
+//		by a test bench's video decoder or by ddr_model: writing it to
+//	the output directory, checking it against a golden frame, logging its
+//	hash, streaming it, and publishing it to shared memory, each as the
+//	scenario asks.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#include <stdio.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+#include "frameout.h"
+#include "framediff.h"
+
+FRAMEOUT::FRAMEOUT(void) {
+	m_outdir = NULL;
+	m_golden = NULL;
+	m_min_psnr = 0;
+	m_hashlog = NULL;
+	m_width = m_height = 0;
+	m_golden_fails = 0;
+}
+
+bool	FRAMEOUT::mkoutdir(const SCENARIO &sc) {
+	// {{{
+	char	fname[512];
+	FILE	*fp;
+
+	if (!sc.m_outdir)
+		return true;
+
+	if (mkdir(sc.m_outdir, 0755) != 0 && errno != EEXIST) {
+		fprintf(stderr, "ERR: Cannot create %s\n", sc.m_outdir);
+		perror("O/S Err:");
+		return false;
+	}
+
+	snprintf(fname, sizeof(fname), "%s/scenario", sc.m_outdir);
+	if ((fp = fopen(fname, "w")) != NULL) {
+		sc.dump(fp);
+		fclose(fp);
+	}
+	return true;
+}
+// }}}
+
+bool	FRAMEOUT::open(const SCENARIO &sc, int w, int h) {
+	// {{{
+	m_outdir   = sc.m_outdir;
+	m_golden   = sc.m_golden;
+	m_min_psnr = sc.m_psnr;
+	m_width    = w;
+	m_height   = h;
+	if (sc.m_hashes && !(m_hashlog = fopen(sc.m_hashes, "w"))) {
+		fprintf(stderr, "ERR: Cannot open %s\n", sc.m_hashes);
+		perror("O/S Err:");
+		return false;
+	}
+	if (sc.m_stream && !m_stream.open(sc.m_stream, w, h))
+		return false;
+	if (sc.m_shm && !m_shm.create(sc.m_shm, w, h))
+		return false;
+	return true;
+}
+// }}}
+
+void	FRAMEOUT::frame(unsigned long fr, const unsigned *px) {
+	// {{{
+	char	fname[512];
+
+	if (m_outdir) {
+		snprintf(fname, sizeof(fname), "%s/frame%05lu.ppm",
+			m_outdir, fr);
+		writeppm(fname, px, m_width, m_height);
+	}
+
+	if (m_golden) {
+		FRAMEDIFF	d;
+
+		snprintf(fname, sizeof(fname), "%s/frame%05lu.ppm",
+			m_golden, fr);
+		if (!diffppm(fname, px, m_width, m_height, d))
+			m_golden_fails++;
+		else if (d.m_pixels != 0) {
+			printf("FRAME %lu: %lu pixels, within (%d,%d)-(%d,%d), differ from %s.  PSNR = %.2f dB\n",
+				fr, d.m_pixels, d.m_x0, d.m_y0,
+				d.m_x1-1, d.m_y1-1, fname, d.m_psnr);
+			if (m_min_psnr <= 0 || d.m_psnr < m_min_psnr)
+				m_golden_fails++;
+		}
+	}
+
+	if (m_hashlog)
+		fprintf(m_hashlog, "%6lu %016lx\n", fr,
+			framehash(px, (size_t)m_width * m_height));
+	m_stream.write(px);
+	m_shm.publish(px);
+}
+// }}}
+
+void	FRAMEOUT::close(void) {
+	m_stream.close();
+	if (m_hashlog) {
+		fclose(m_hashlog);
+		m_hashlog = NULL;
+	}
+}
+
+bool	FRAMEOUT::passed(FILE *fp) const {
+	if (m_golden_fails == 0)
+		return true;
+	if (fp)
+		fprintf(fp, "FAIL: %lu frames didn't match those in %s\n",
+			m_golden_fails, m_golden);
+	return false;
+}
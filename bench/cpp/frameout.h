@@ -0,0 +1,91 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/frameout.h
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Everything done with a frame once it's been produced, whether
+//		by a test bench's video decoder or by ddr_model: writing it to
+//	the output directory, checking it against a golden frame, logging its
+//	hash, streaming it, and publishing it to shared memory, each as the
+//	scenario asks.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#ifndef	FRAMEOUT_H
+#define	FRAMEOUT_H
+
+#include <stdio.h>
+#include "scenario.h"
+#include "framewriter.h"
+#include "shmframes.h"
+
+// FRAMEOUT
+// {{{
+// Writes, checks, and publishes w x h frames of 0x00RRGGBB pixels, as
+// decoded by VIDEODEC.  The names given are kept, not copied, and so must
+// outlast the FRAMEOUT.
+class	FRAMEOUT {
+public:
+	const char	*m_outdir, *m_golden;
+	double		m_min_psnr;	// Golden frames may differ by this much
+	FILE		*m_hashlog;
+	FRAMEWRITER	m_stream;
+	SHMFRAMES	m_shm;
+	int		m_width, m_height;
+	unsigned long	m_golden_fails;
+
+	FRAMEOUT(void);
+	~FRAMEOUT(void) { close(); }
+
+	// Creates the scenario's output directory, if any, and keeps a
+	// record there of how its frames were made
+	static	bool	mkoutdir(const SCENARIO &sc);
+
+	// Takes the output directory, golden frames, hash log, stream, and
+	// shared memory ring from the scenario, for w x h frames.  Returns
+	// false, having said why, should any fail to open.
+	bool	open(const SCENARIO &sc, int w, int h);
+
+	// Does all of the above with frame number fr.  A golden frame fails
+	// if it can't be read, if it differs at all or, given m_min_psnr, if
+	// it differs by more than that.
+	void	frame(unsigned long fr, const unsigned *px);
+
+	// Finishes the stream, and closes the hash log
+	void	close(void);
+
+	// Reports (to fp, if not NULL) any golden frames that failed, and
+	// returns true if none did
+	bool	passed(FILE *fp = stdout) const;
+};
+// }}}
+#endif
@@ -0,0 +1,294 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/framewriter.cpp
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Streams decoded video frames, as described in framewriter.h.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "framewriter.h"
+
+FRAMEWRITER::FRAMEWRITER(void) {
+	// {{{
+	m_format = FW_RGB;
+	m_fd = -1;
+	m_width = m_height = 0;
+	m_fps = 60;
+	m_frames = m_dropped = 0;
+	m_block = false;
+	m_front = m_back = NULL;
+	m_out = NULL;
+	m_back_full = m_quit = m_failed = false;
+}
+// }}}
+
+bool	FRAMEWRITER::open(const char *name, int w, int h, int fps) {
+	// {{{
+	const char	*ext;
+	struct stat	sb;
+
+	close();
+
+	if (strncmp(name, "y4m:", 4) == 0) {
+		m_format = FW_Y4M;
+		name += 4;
+	} else if (strncmp(name, "rgb:", 4) == 0) {
+		m_format = FW_RGB;
+		name += 4;
+	} else {
+		ext = strrchr(name, '.');
+		m_format = (ext && strcmp(ext, ".y4m") == 0) ? FW_Y4M : FW_RGB;
+	}
+
+	// A reader going away should end the stream, not the simulation
+	signal(SIGPIPE, SIG_IGN);
+
+	if (strcmp(name, "-") == 0) {
+		fflush(stdout);
+		m_fd = dup(STDOUT_FILENO);
+		if (m_fd >= 0)
+			dup2(STDERR_FILENO, STDOUT_FILENO);
+	} else
+		// Opening a named pipe waits here for its reader
+		m_fd = ::open(name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (m_fd < 0) {
+		fprintf(stderr, "ERR: Cannot open %s for writing\n", name);
+		perror("O/S Err:");
+		return false;
+	}
+
+	// Nothing's waiting on the other end of a file, so no frame need
+	// ever be dropped.  (This includes stdout, if redirected to one.)
+	m_block = (fstat(m_fd, &sb) == 0 && S_ISREG(sb.st_mode));
+
+	m_width  = w;
+	m_height = h;
+	m_fps    = fps;
+	m_frames = m_dropped = 0;
+	m_back_full = m_quit = m_failed = false;
+	m_front = new unsigned[w*h];
+	m_back  = new unsigned[w*h];
+	m_out   = new unsigned char[3*w*h];
+
+	if (m_format == FW_Y4M) {
+		char	hdr[128];
+		int	n;
+
+		n = snprintf(hdr, sizeof(hdr),
+			"YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n", w, h, fps);
+		m_failed = !put(hdr, n);
+	}
+
+	pthread_mutex_init(&m_lock, NULL);
+	pthread_cond_init(&m_cond, NULL);
+	if (pthread_create(&m_thread, NULL, writer, this) != 0) {
+		perror("O/S Err:");
+		pthread_cond_destroy(&m_cond);
+		pthread_mutex_destroy(&m_lock);
+		::close(m_fd);
+		m_fd = -1;
+		return false;
+	}
+
+	return true;
+}
+// }}}
+
+void	FRAMEWRITER::write(const unsigned *pixels) {
+	// {{{
+	bool	busy, failed;
+
+	if (m_fd < 0)
+		return;
+
+	pthread_mutex_lock(&m_lock);
+	if (m_block) {
+		while(m_back_full && !m_failed)
+			pthread_cond_wait(&m_cond, &m_lock);
+	}
+	failed = m_failed;
+	busy = m_back_full || failed;
+	pthread_mutex_unlock(&m_lock);
+
+	if (busy) {
+		if (!failed)
+			fprintf(stderr, "WARNING: Video stream frame %lu dropped, its reader has fallen behind\n",
+				m_frames + m_dropped);
+		m_dropped++;
+		return;
+	}
+
+	// The writer thread leaves the back buffer alone until it's full
+	memcpy(m_back, pixels, m_width * m_height * sizeof(unsigned));
+
+	pthread_mutex_lock(&m_lock);
+	m_back_full = true;
+	pthread_cond_signal(&m_cond);
+	pthread_mutex_unlock(&m_lock);
+	m_frames++;
+}
+// }}}
+
+void	FRAMEWRITER::close(void) {
+	// {{{
+	if (m_fd < 0)
+		return;
+
+	pthread_mutex_lock(&m_lock);
+	m_quit = true;
+	pthread_cond_signal(&m_cond);
+	pthread_mutex_unlock(&m_lock);
+	pthread_join(m_thread, NULL);
+
+	pthread_cond_destroy(&m_cond);
+	pthread_mutex_destroy(&m_lock);
+	::close(m_fd);
+	m_fd = -1;
+
+	if (m_dropped > 0)
+		fprintf(stderr, "WARNING: %lu of %lu frames were dropped from the video stream\n",
+			m_dropped, m_frames + m_dropped);
+
+	delete[] m_front;
+	delete[] m_back;
+	delete[] m_out;
+	m_front = m_back = NULL;
+	m_out = NULL;
+}
+// }}}
+
+void	*FRAMEWRITER::writer(void *vp) {
+	// {{{
+	FRAMEWRITER	*fw = (FRAMEWRITER *)vp;
+
+	for(;;) {
+		unsigned	*tmp;
+		bool		ok;
+
+		pthread_mutex_lock(&fw->m_lock);
+		while(!fw->m_back_full && !fw->m_quit)
+			pthread_cond_wait(&fw->m_cond, &fw->m_lock);
+		if (!fw->m_back_full) {
+			// Quitting, with nothing left to write
+			pthread_mutex_unlock(&fw->m_lock);
+			break;
+		}
+
+		tmp = fw->m_front;
+		fw->m_front = fw->m_back;
+		fw->m_back  = tmp;
+		fw->m_back_full = false;
+		// Any write() waiting on the back buffer may now have it
+		pthread_cond_broadcast(&fw->m_cond);
+		pthread_mutex_unlock(&fw->m_lock);
+
+		fw->format(fw->m_front);
+		if (fw->m_format == FW_Y4M)
+			ok = fw->put("FRAME\n", 6);
+		else
+			ok = true;
+		ok = ok && fw->put(fw->m_out, 3ul * fw->m_width * fw->m_height);
+
+		if (!ok) {
+			pthread_mutex_lock(&fw->m_lock);
+			fw->m_failed = true;
+			pthread_cond_broadcast(&fw->m_cond);
+			pthread_mutex_unlock(&fw->m_lock);
+			break;
+		}
+	}
+
+	return NULL;
+}
+// }}}
+
+void	FRAMEWRITER::format(const unsigned *pixels) {
+	// {{{
+	const int	n = m_width * m_height;
+
+	if (m_format == FW_RGB) {
+		for(int k=0; k<n; k++) {
+			m_out[3*k  ] = (pixels[k] >> 16) & 0x0ff;
+			m_out[3*k+1] = (pixels[k] >>  8) & 0x0ff;
+			m_out[3*k+2] = (pixels[k]      ) & 0x0ff;
+		}
+	} else {
+		// Y4M: three planes, Y, Cb, then Cr, using the (studio swing)
+		// BT.601 integer approximations
+		unsigned char	*y = m_out, *cb = &m_out[n], *cr = &m_out[2*n];
+
+		for(int k=0; k<n; k++) {
+			int	r = (pixels[k] >> 16) & 0x0ff,
+				g = (pixels[k] >>  8) & 0x0ff,
+				b = (pixels[k]      ) & 0x0ff;
+
+			y[k]  = (( 66*r + 129*g +  25*b + 128) >> 8) +  16;
+			cb[k] = ((-38*r -  74*g + 112*b + 128) >> 8) + 128;
+			cr[k] = ((112*r -  94*g -  18*b + 128) >> 8) + 128;
+		}
+	}
+}
+// }}}
+
+bool	FRAMEWRITER::put(const void *buf, unsigned long len) {
+	// {{{
+	const char	*ptr = (const char *)buf;
+
+	while(len > 0) {
+		ssize_t	nw = ::write(m_fd, ptr, len);
+
+		if (nw < 0 && errno == EINTR)
+			continue;
+		if (nw <= 0) {
+			if (errno == EPIPE)
+				fprintf(stderr, "WARNING: The video stream's reader has gone away\n");
+			else
+				perror("O/S Err:");
+			return false;
+		}
+
+		ptr += nw;
+		len -= nw;
+	}
+
+	return true;
+}
+// }}}
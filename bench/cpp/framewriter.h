@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/framewriter.h
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Streams decoded video frames to a file, named pipe, or stdout,
+//		so that an encoder or viewer may record or watch the simulation
+//	as it runs.  For example,
+//
+//		mkfifo video.y4m; ffplay video.y4m &
+//		./ddr_headless -v video.y4m
+//
+//	or
+//
+//		./ddr_headless -v y4m:- | ffmpeg -i - demo.mp4
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#ifndef	FRAMEWRITER_H
+#define	FRAMEWRITER_H
+
+#include <pthread.h>
+
+// FRAMEWRITER
+// {{{
+// Streams frames, as decoded by VIDEODEC (0x00RRGGBB pixels), to a file,
+// named pipe, or stdout, as either raw 24-bit RGB or Y4M (4:4:4).  The
+// frames are written by a thread of its own, from the second of two
+// buffers, so the simulation usually waits on no more than a copy of the
+// frame.  If both buffers are still in use when the next frame arrives,
+// a regular file waits for the writer to catch up, so that every frame is
+// kept.  Anything else--a pipe, a terminal--has a reader on the other end
+// that has fallen behind, and that frame is dropped (and reported) rather
+// than stall the simulation on it.
+class	FRAMEWRITER {
+public:
+	enum	FWFORMAT { FW_RGB, FW_Y4M };
+
+	FWFORMAT	m_format;
+	int		m_fd, m_width, m_height, m_fps;
+	unsigned long	m_frames, m_dropped;
+	bool		m_block;	// Wait, rather than drop frames
+
+	FRAMEWRITER(void);
+	~FRAMEWRITER(void) { close(); }
+
+	// Opens name for writing, and starts the writer thread.  A name
+	// of "-" means stdout--in which case anything else the program
+	// prints to stdout is sent to stderr instead.  The format is Y4M
+	// if the name ends in .y4m, raw RGB otherwise, unless it begins
+	// with "y4m:" or "rgb:" to say otherwise.
+	bool	open(const char *name, int w, int h, int fps = 60);
+
+	// Queues a w x h frame to be written.  Only blocks on I/O if
+	// m_block, as it is for regular files.
+	void	write(const unsigned *pixels);
+
+	// Writes any frame still pending, and closes the stream
+	void	close(void);
+
+	bool	isopen(void) const { return m_fd >= 0; }
+
+private:
+	pthread_t	m_thread;
+	pthread_mutex_t	m_lock;
+	pthread_cond_t	m_cond;
+	unsigned	*m_front, *m_back;	// Being written, being filled
+	unsigned char	*m_out;
+	bool		m_back_full, m_quit, m_failed;
+
+	static	void	*writer(void *vp);
+	void	format(const unsigned *pixels);
+	bool	put(const void *buf, unsigned long len);
+};
+// }}}
+#endif
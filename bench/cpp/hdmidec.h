@@ -0,0 +1,122 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/hdmidec.h
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Decodes the three TMDS encoded HDMI channels from a Verilator
+//		based test bench into an image, without any GUI.  HDMISIM
+//	builds a gtkmm window on top of this.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#ifndef	HDMIDEC_H
+#define	HDMIDEC_H
+
+#include "videodec.h"
+
+#define	VIDEO_GUARD	0
+#define	VIDEO_DATA	1
+#define	CTL_PERIOD	2
+#define	DATA_GUARD	3
+#define	DATA_ISLAND	4
+#define	HDMI_LOST	5
+
+class	HDMIDEC : public VIDEODEC {
+public:
+	static	const	bool	m_debug;
+
+	// Everything we might want to know about a received TMDS symbol,
+	// indexed by the raw 10-bit symbol as it comes from the design
+	typedef	struct	TMDSDEC_S {
+		unsigned char	m_pixel;	// Decoded 8-bit video data
+		signed char	m_ctl;		// Control code, 0-3, else -1
+		signed char	m_terc4;	// TERC4 nibble, 0-15, else -1
+		bool		m_guard;	// True for guard band symbols
+	} TMDSDEC;
+
+	static	TMDSDEC	m_tmds[1024];
+	static	void	build_tables(void);
+
+	bool	m_out_of_sync;
+
+	int	m_last_vsync, m_last_hsync, m_last_r, m_last_g, m_last_b,
+		m_pixel_clock_count;
+	int	m_state, m_state_counter;
+	int	m_vsync_count, m_hsync_count;
+
+	void	initialize(void) {
+		// Build our decoding tables, once, the first time through
+		static	const	bool	built = (build_tables(), true);
+		(void)built;
+
+		m_vsync_count = 0;
+		m_hsync_count = 0;
+
+		m_state = CTL_PERIOD;
+		m_state_counter = 0;
+
+		m_out_of_sync = true;
+
+		m_last_hsync = m_last_vsync = 0;
+		m_last_r = m_last_g = m_last_b = 0;
+		m_pixel_clock_count = 0;
+	}
+
+public:
+	static	const	int	CLOCKS_PER_PIXEL,
+				BITS_PER_COLOR;
+
+	static	int	bitreverse(int val);
+	static	bool	isguard(int val);
+	static	int	ctldata(int val);
+	static	int	pktdata(int val);
+	static	int	pixeldata(int val);
+
+	HDMIDEC(void) : VIDEODEC(640,480) {
+		initialize();
+	}
+
+	HDMIDEC(const int w, const int h) : VIDEODEC(w, h) {
+		initialize();
+	}
+
+	HDMIDEC(const char *h, const char *v) : VIDEODEC(h,v) {
+		initialize();
+	}
+
+	void	operator()(const int blu, const int grn, const int red);
+	bool	syncd(void) const { return !m_out_of_sync; }
+
+	virtual	void	save(FILE *fp) const;
+	virtual	bool	restore(FILE *fp);
+};
+
+#endif
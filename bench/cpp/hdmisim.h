@@ -39,20 +39,10 @@
 #define	HDMISIM_H
 
 #include <gtkmm.h>
-#include "image.h"
-#include "videomode.h"
+#include "hdmidec.h"
 #include "simwin.h"
 
-#define	VIDEO_GUARD	0
-#define	VIDEO_DATA	1
-#define	CTL_PERIOD	2
-#define	DATA_GUARD	3
-#define	DATA_ISLAND	4
-#define	HDMI_LOST	5
-
-extern	int	gbl_nframes;
-
-class	HDMISIM : public Gtk::DrawingArea {
+class	HDMISIM : public Gtk::DrawingArea, public HDMIDEC {
 public:
 	// Type definitions ... just to make using these types easier and
 	// simpler on the fingers.
@@ -60,57 +50,25 @@ public:
 	typedef	const Cairo::RefPtr<Cairo::Context>	CONTEXT;
 	typedef	Cairo::RefPtr<Cairo::ImageSurface>	CAIROIMG;
 
-	static	const	bool	m_debug;
-
 	CAIROIMG		m_pix;
 	CAIROGC			m_gc;
-	IMAGE<unsigned>		*m_data;
-	VIDEOMODE		m_mode;
-	bool	m_out_of_sync;
-
-	int	m_last_vsync, m_last_hsync, m_last_r, m_last_g, m_last_b,
-		m_pixel_clock_count;
-	int	m_state, m_state_counter;
-	int	m_vsync_count, m_hsync_count;
 
 	void	initialize(void) {
-		m_data = new IMAGE<unsigned>(m_mode.height(), m_mode.width());
-		m_data->zeroize();
-
-		m_vsync_count = 0;
-		m_hsync_count = 0;
-
 		set_has_window(true);
 		Widget::set_can_focus(false);
 		set_size_request(m_mode.width(), m_mode.height());
-
-		m_state = CTL_PERIOD;
-		m_state_counter = 0;
-
-		m_out_of_sync = true;
 	}
 
 public:
-	static	const	int	CLOCKS_PER_PIXEL,
-				BITS_PER_COLOR;
-
-	static	int	bitreverse(int val);
-	static	bool	isguard(int val);
-	static	int	ctldata(int val);
-	static	int	pktdata(int val);
-	static	int	pixeldata(int val);
-
-
-
-	HDMISIM(void) : Gtk::DrawingArea(), m_mode(640,480) {
+	HDMISIM(void) : Gtk::DrawingArea(), HDMIDEC(640,480) {
 		initialize();
 	}
 
-	HDMISIM(const int w, const int h) : Gtk::DrawingArea(), m_mode(w, h) {
+	HDMISIM(const int w, const int h) : Gtk::DrawingArea(), HDMIDEC(w, h) {
 		initialize();
 	}
 
-	HDMISIM(const char *h, const char *v) : Gtk::DrawingArea(), m_mode(h,v) {
+	HDMISIM(const char *h, const char *v) : Gtk::DrawingArea(), HDMIDEC(h,v) {
 		initialize();
 	}
 
@@ -121,9 +79,9 @@ public:
 
 	virtual	void	on_realize();
 
-	void	operator()(const int blu, const int grn, const int red);
+	virtual	void	line_changed(int y, int x0, int x1);
+	virtual	bool	restore(FILE *fp);
 	virtual	bool	on_draw(CONTEXT &gc);
-	bool	syncd(void) { return !m_out_of_sync; }
 };
 
 class	HDMIWIN	: public SIMWIN {
@@ -140,6 +98,16 @@ public:
 		(*m_hdmisim)(blu,grn,red);
 	}
 	bool	syncd(void) const { return m_hdmisim->syncd(); }
+	unsigned long	nframes(void) const { return m_hdmisim->nframes(); }
+	unsigned long	resyncs(void) const { return m_hdmisim->resyncs(); }
+	bool	writeppm(const char *fname) const {
+		return m_hdmisim->writeppm(fname); }
+	bool	diffppm(const char *fname, FRAMEDIFF &d) const {
+		return m_hdmisim->diffppm(fname, d); }
+	unsigned long	hash(void) const { return m_hdmisim->hash(); }
+	const unsigned	*pixels(void) const { return m_hdmisim->pixels(); }
+	void	save(FILE *fp) const { m_hdmisim->save(fp); }
+	bool	restore(FILE *fp) { return m_hdmisim->restore(fp); }
 };
 
 #endif
@@ -0,0 +1,114 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/logfn.h
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	A bit exact model of rtl/fft/logfn.v, turning each (complex) FFT
+//		output into the eight bit log magnitude that the rest of the
+//	design writes to memory, and then displays.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#ifndef	LOGFN_H
+#define	LOGFN_H
+
+#include <stdint.h>
+
+// logfn()
+// {{{
+// Returns the eight bit pixel rtl/fft/logfn.v produces from one FFT output,
+// { i_real, i_imag }: five bits of log_2(re^2+im^2), followed by the three
+// bits following its leading one.  The RTL finds that leading one in two
+// steps, first by nibbles (of five bits) and then by bits, and this follows
+// the same steps--quirks and all--rather than just counting bits.
+static inline	unsigned	logfn(int re, int im) {
+	const uint64_t	MSK = (1ull << 33)-1;
+	uint64_t	squard, pshiftd, shiftd;
+	unsigned	znibs, preshift, shft;
+
+	squard = ((int64_t)re * re + (int64_t)im * im) & MSK;
+
+	// Count the number of zero nibbles on the left
+	znibs  = (((squard >> 30) & 0x07) == 0) ? 0x40 : 0;
+	for(int k=5; k>=0; k--)
+		if (((squard >> (5*k)) & 0x1f) == 0)
+			znibs |= (1<<k);
+
+	// Stage one: Shift by multiples of five bits
+	if ((znibs & 0x60) == 0x40)
+		preshift = 3;
+	else if ((znibs & 0x70) == 0x60)
+		preshift = 8;
+	else if ((znibs & 0x78) == 0x70)
+		preshift = 13;
+	else if ((znibs & 0x7c) == 0x78)
+		preshift = 18;
+	else if ((znibs & 0x7e) == 0x7c)
+		preshift = 23;
+	else if (znibs == 0x7e)
+		preshift = 28;
+	else
+		preshift = 0;
+	pshiftd = (squard << preshift) & MSK;
+
+	// Stage two: Shift by any remaining bits
+	switch((pshiftd >> 27) & 0x3f) {
+	case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39:
+	case 40: case 41: case 42: case 43: case 44: case 45: case 46: case 47:
+	case 48: case 49: case 50: case 51: case 52: case 53: case 54: case 55:
+	case 56: case 57: case 58: case 59: case 60: case 61: case 62: case 63:
+		shft = preshift;   shiftd = pshiftd;      break;
+	case 16: case 17: case 18: case 19: case 20: case 21: case 22: case 23:
+	case 24: case 25: case 26: case 27: case 28: case 29: case 30: case 31:
+		shft = preshift+1; shiftd = pshiftd << 1; break;
+	case  8: case  9: case 10: case 11: case 12: case 13: case 14: case 15:
+		shft = preshift+2; shiftd = pshiftd << 2; break;
+	case  4: case  5: case  6: case  7:
+		shft = preshift+3; shiftd = pshiftd << 3; break;
+	case  2: case  3:
+		shft = preshift+4; shiftd = pshiftd << 4; break;
+	case  1:	// Yes, the RTL really does shift by five here
+		shft = preshift+4; shiftd = pshiftd << 5; break;
+	default:
+		shft = preshift+5; shiftd = pshiftd << 6; break;
+	}
+	shiftd &= MSK;
+
+	// Stage three: grab the upper 8-bits of the shifted value
+	if ((shft & 0x3f) == 0)
+		return 0xff;
+	else if (shiftd >> 32)
+		return (((-shft) & 0x1f) << 3) | ((shiftd >> 29) & 7);
+	return 0;
+}
+// }}}
+
+#endif
@@ -44,63 +44,60 @@
 ////////////////////////////////////////////////////////////////////////////////
 //
 // }}}
-#include <signal.h>
-#include <time.h>
-#include <ctype.h>
-
 #include "verilated.h"
-#include "verilated_vcd_c.h"
 #include "Vmain.h"
+#ifdef	ROOT_VERILATOR
+#include "Vmain___024root.h"
+#endif
 
-#include "testb.h"
 // #include "twoc.h"
-#include "hdmisim.h"
+#ifdef	HEADLESS
+#include "vgadec.h"
+#else
 #include "vgasim.h"
-#include "micnco.h"
+#endif
 
-#ifdef	NEW_VERILATOR
-#define	VVAR(A)	busmaster__DOT_ ## A
+#ifdef	ROOT_VERILATOR
+#define	VVAR(A)	rootp->main__DOT_ ## A
+#elif	defined(NEW_VERILATOR)
+#define	VVAR(A)	main__DOT_ ## A
 #else
 #define	VVAR(A)	v__DOT_ ## A
 #endif
 
+#include "benchmain.h"
 
 // No particular "parameters" need definition or redefinition here.
 #define	BASE	Vmain
 
-class	TESTBENCH : public TESTB<BASE> {
+class	TESTBENCH : public BENCHMAIN<BASE, TESTBENCH> {
 public:
 	unsigned long	m_tx_busy_count;
+#ifdef	HEADLESS
+	VGADEC		m_vga;
+#else
 	VGAWIN		m_vga;
+#endif
 #define	m_win	m_vga
-	MICNCO		m_micnco;
-	bool		m_done;
 
 	TESTBENCH(void) : m_win(800, 600) {
-		//
-		m_core->i_reset = 1;
-		//
-		m_done = false;
-
-		TESTB<BASE>::m_pixclk.set_frequency_hz(m_win.clocks_per_frame() * 60);
-		Glib::signal_idle().connect(sigc::mem_fun((*this),
-				&TESTBENCH::on_tick));
-	}
-
-	void	openvcd(const char *vcd_trace_file_name) {
-		fprintf(stderr, "Opening TRACE(%s)\n", vcd_trace_file_name);
-		openvcd(vcd_trace_file_name);
-	}
+		// Signals that may be probed, or traced upon
+		add_probes(20);
+		m_probes.add("o_vga_vsync", &m_core->o_vga_vsync);
+		m_probes.add("o_vga_hsync", &m_core->o_vga_hsync);
+		m_probes.add("o_adc_csn", &m_core->o_adc_csn);
+#ifdef	ADC_BYPASS
+		m_probes.add("i_adc_ce", &m_core->i_adc_ce);
+#endif
 
-	void	close(void) {
-		// TESTB<BASECLASS>::closetrace();
-		m_done = true;
+		TESTB<BASE, TESTBENCH>::m_pixclk.set_frequency_hz(m_win.clocks_per_frame() * 60);
 	}
 
-	void	sim_clk_tick(void) {
-		m_core->i_adc_miso = m_micnco(m_core->o_adc_sck,
-					m_core->o_adc_csn);
-	}
+#ifdef	HEADLESS
+	VGADEC	&video(void) { return m_vga; }
+#else
+	VGAWIN	&video(void) { return m_vga; }
+#endif
 
 	void	sim_pixclk_tick(void) {
 		m_vga((m_core->o_vga_vsync)?0:1, (m_core->o_vga_hsync)?0:1,
@@ -109,40 +106,91 @@ public:
 			m_core->o_vga_blu);
 	}
 
-	void	tick(void) {
-		if (m_done)
-			return;
-
-		TESTB<BASE>::tick();
+	// scoreboard()
+	// {{{
+	// Starts checking each stage of the design against its model.  The
+	// filter must match the one in main.v.
+	bool	scoreboard(void) {
+		SUBFILDOWN	*fil = new SUBFILDOWN(12, 20, 12, 23, 1023, 2);
 
-		if (gbl_nframes > 180) {
-			exit(EXIT_SUCCESS);
-			m_done = true;
+		if (!fil->ok() || !fil->load("subfildown.hex")) {
+			delete fil;
+			return false;
 		}
+		return m_sb.start(m_probes, fil, 0);
 	}
+	// }}}
 
-	bool	on_tick(void) {
-		for(int i=0; i<32; i++)
-			tick();
-		return !m_done;
+#ifdef	SWEEP
+	static	TESTBENCH *sweep_create(const SWEEPSET &, const SWEEPJOB &) {
+		return new TESTBENCH();
 	}
+
+	void	sweep_stats(SWEEPJOB &) {}
+#endif
 };
 
-TESTBENCH	*tb;
+#if	defined(SWEEP)
+#define	PROGNAME	"main_sweep"
+#elif	defined(ADC_BYPASS)
+#define	PROGNAME	"main_bypass"
+#elif	defined(NO_TRACE)
+#define	PROGNAME	"main_mt"
+#elif	defined(TRACE_FST)
+#define	PROGNAME	"main_fst"
+#elif	defined(HEADLESS)
+#define	PROGNAME	"main_headless"
+#else
+#define	PROGNAME	"main_tb"
+#endif
 
 int	main(int argc, char **argv) {
+#if	defined(SWEEP)
+	exit(sweep<TESTBENCH>(PROGNAME, false, argc, argv));
+#else
+	// {{{
+	TESTBENCH	*tb;
+	SCENARIO	sc;
+	STIMULUS	*stim = NULL;
+	bool		pass;
+#ifdef	HEADLESS
+	struct timespec	tstart;
+	unsigned long	frame0, ticks0;
+#else
 	Gtk::Main	main_instance(argc, argv);
-	Verilated::commandArgs(argc, argv);
+#endif
 
-	tb = new TESTBENCH();
-	tb->reset();
+	if (!bench_scenario(sc, PROGNAME, "VGA", false, argc, argv))
+		exit(EXIT_FAILURE);
 
-	if (false) {
-		printf("Writing a trace file\n");
-		tb->openvcd("fftdemo.vcd");
-	}
+	if (sc.m_stim && !(stim = make_stimulus(sc.m_stim)))
+		exit(EXIT_FAILURE);
+
+	if (!FRAMEOUT::mkoutdir(sc))
+		exit(EXIT_FAILURE);
+
+	tb = new TESTBENCH();
+	tb->commandArgs(argc, argv);
+	if (!bench_start(tb, sc, stim))
+		exit(EXIT_FAILURE);
+
+#ifdef	HEADLESS
+	frame0 = tb->m_vga.nframes();
+	ticks0 = tb->m_clk.ticks();
+
+	clock_gettime(CLOCK_MONOTONIC, &tstart);
+	while(!tb->m_done)
+		tb->tick();
+	bench_speed(tb, frame0, ticks0, tstart);
+#else
 	Gtk::Main::run(tb->m_win);
+#endif
 
-	exit(0);
-}
+	pass = bench_finish(tb, sc);
 
+	delete tb;
+	delete stim;
+	exit((pass) ? EXIT_SUCCESS : EXIT_FAILURE);
+	// }}}
+#endif
+}
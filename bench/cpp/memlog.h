@@ -0,0 +1,67 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/memlog.h
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Defines the format of the binary memory transaction log written
+//		by MEMSIM, and read back by memreplay.  The log records
+//	every request the memory accepts: when it was made, its address, the
+//	data written or read, the byte selects, and whether it was a read or a
+//	write.  At 16 bytes per request, this is compact enough to capture
+//	many frames worth of bus traffic.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#ifndef	MEMLOG_H
+#define	MEMLOG_H
+
+#include <stdint.h>
+
+// A log starts with this magic string, followed by a uint32_t count of the
+// MEMSTATS sources and then the name of each source (MEMLOG_NAMELEN bytes
+// apiece).  Every request accepted by the memory follows, one MEMLOG_REC
+// apiece.
+#define	MEMLOG_MAGIC	"MEMLOG1\n"
+#define	MEMLOG_NAMELEN	32
+
+// Flags
+#define	MEMLOG_WE	0x01	// A write, rather than a read
+#define	MEMLOG_IDLE	0x80	// No request, just m_delta clocks of nothing
+
+#define	MEMLOG_NOTAG	0xff
+
+typedef	struct	MEMLOG_REC_S {
+	uint32_t	m_delta;	// Clocks since the last request
+	uint32_t	m_addr, m_data;	// Data written, or read
+	uint8_t		m_flags, m_sel, m_tag, m_unused;
+} MEMLOG_REC;
+
+#endif
@@ -0,0 +1,236 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/memreplay.cpp
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Replays a memory transaction log, as recorded by MEMSIM (see
+//		memlog.h), back through MEMSIM--with no Verilated model
+//	attached.  This allows the memory's latency, queue depth, and page
+//	policy to be varied, and the resulting stalls, latencies, and
+//	bandwidth to be examined, many times faster than the full design could
+//	be re-simulated.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "memsim.h"
+
+void	usage(void) {
+	// {{{
+	fprintf(stderr,
+"USAGE: memreplay [-cdh] [-f <clocks>] [-l <clocks>] [-q <depth>] [-s <file>]\n"
+"\t\t<logfile>\n"
+"\n"
+"\tReplays a memory transaction log, as written by ddr_headless -m,\n"
+"\tthrough MEMSIM, and reports on how the memory performed.\n"
+"\n"
+"\t-c\tUses a closed page policy, closing every row after it is used.\n"
+"\t\tImplies -d.\n"
+"\t-d\tModels the timing of the DDR3 SDRAM\n"
+"\t-f <clocks>\tThe number of clocks per video frame, for calculating\n"
+"\t\tthe bandwidth used by each frame (default: 100MHz / 60Hz)\n"
+"\t-h\tDisplays this usage statement\n"
+"\t-l <clocks>\tThe latency from request (or, with -d, from the read or\n"
+"\t\twrite command) to acknowledgment.  (default: 27)\n"
+"\t-q <depth>\tThe depth of the DDR3 command queue (default: 16)\n"
+"\t-s <file>\tWrites the bus statistics to <file>.  The file will be\n"
+"\t\tJSON if its name ends in .json, CSV otherwise.\n"
+"\n"
+"\tEach request is made the same number of clocks after the one before\n"
+"\tit was accepted as it was in the log.  Hence, if the memory stalls\n"
+"\tmore (or less) than it did when the log was made, all of the requests\n"
+"\tthat follow are delayed (or advanced) to match.\n");
+}
+// }}}
+
+int	main(int argc, char **argv) {
+	int		opt;
+	bool		timed = false;
+	unsigned	latency = 27;
+	unsigned long	frame_clocks = 1666667, next_frame;
+	const char	*statfile = NULL;
+	DDR3TIMING	tm = NEXYS_VIDEO_DDR3;
+	FILE		*fp;
+	char		magic[16];
+	uint32_t	nsrc;
+	int		tags[256];
+	MEMSIM		*mem;
+	MEMLOG_REC	rec;
+	unsigned long	nreq = 0, logged_clocks = 0, wait;
+	struct timespec	tstart, tstop;
+	double		elapsed;
+
+	while((opt = getopt(argc, argv, "cdf:hl:q:s:")) != -1) {
+		switch(opt) {
+		case 'c': timed = true; tm.m_open_page = false; break;
+		case 'd': timed = true; break;
+		case 'f': frame_clocks = strtoul(optarg, NULL, 0); break;
+		case 'h': usage(); exit(EXIT_SUCCESS); break;
+		case 'l': latency = strtoul(optarg, NULL, 0); break;
+		case 'q': tm.m_depth = strtoul(optarg, NULL, 0); break;
+		case 's': statfile = optarg; break;
+		default:
+			usage();
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if ((optind+1 != argc)||(latency < 1)||(tm.m_depth < 1)) {
+		usage();
+		exit(EXIT_FAILURE);
+	}
+
+	// Read the log header
+	// {{{
+	fp = fopen(argv[optind], "rb");
+	if (!fp) {
+		fprintf(stderr, "ERR: Could not open %s\n", argv[optind]);
+		perror("O/S Err:");
+		exit(EXIT_FAILURE);
+	}
+
+	if (fread(magic, 1, strlen(MEMLOG_MAGIC), fp) != strlen(MEMLOG_MAGIC)
+		|| memcmp(magic, MEMLOG_MAGIC, strlen(MEMLOG_MAGIC)) != 0
+		|| fread(&nsrc, sizeof(nsrc), 1, fp) != 1) {
+		fprintf(stderr, "ERR: %s is not a memory transaction log\n",
+			argv[optind]);
+		exit(EXIT_FAILURE);
+	} else if (nsrc > (unsigned)MEMSTATS::MAX_SOURCES) {
+		fprintf(stderr, "ERR: %s has %u sources, more than the %d supported\n",
+			argv[optind], nsrc, MEMSTATS::MAX_SOURCES);
+		exit(EXIT_FAILURE);
+	}
+
+	mem = new MEMSIM(1<<27, latency, (timed) ? &tm : NULL);
+
+	for(int k=0; k<256; k++)
+		tags[k] = -1;
+	for(unsigned k=0; k<nsrc; k++) {
+		char	name[MEMLOG_NAMELEN+1];
+
+		if (fread(name, 1, MEMLOG_NAMELEN, fp) != MEMLOG_NAMELEN) {
+			fprintf(stderr, "ERR: %s is truncated\n", argv[optind]);
+			exit(EXIT_FAILURE);
+		}
+		name[MEMLOG_NAMELEN] = '\0';
+
+		// Source zero, "other", always exists already
+		if (k == 0)
+			tags[k] = 0;
+		else
+			tags[k] = mem->m_stats.add_source(name);
+	}
+	// }}}
+
+	// Replay the log
+	// {{{
+	clock_gettime(CLOCK_MONOTONIC, &tstart);
+	next_frame = frame_clocks;
+	wait = 0;
+	while(fread(&rec, sizeof(rec), 1, fp) == 1) {
+		unsigned char	ack, stall;
+		MEMSIM::BUSW	data;
+		bool		accepted = false;
+
+		logged_clocks += rec.m_delta;
+		wait += rec.m_delta;
+		if (rec.m_flags & MEMLOG_IDLE)
+			continue;
+
+		// Idle until it's time to make this request
+		for(; wait > 1; wait--) {
+			mem->apply(0, 0, 0, 0, 0, 0, ack, stall, data);
+			if (mem->m_stats.m_clocks >= next_frame) {
+				mem->m_stats.frame();
+				next_frame += frame_clocks;
+			}
+		}
+
+		// Then make the request, holding it until it's accepted
+		while(!accepted) {
+			mem->apply(1, 1, rec.m_flags & MEMLOG_WE, rec.m_addr,
+				rec.m_data, rec.m_sel, ack, stall, data,
+				tags[rec.m_tag]);
+			accepted = !stall;
+			if (mem->m_stats.m_clocks >= next_frame) {
+				mem->m_stats.frame();
+				next_frame += frame_clocks;
+			}
+		}
+
+		wait = 0;
+		nreq++;
+	}
+	fclose(fp);
+
+	// Wait for the last acks to return
+	for(unsigned k=0; k<latency + tm.m_depth + 64; k++) {
+		unsigned char	ack, stall;
+		MEMSIM::BUSW	data;
+
+		mem->apply(0, 0, 0, 0, 0, 0, ack, stall, data);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &tstop);
+	// }}}
+
+	elapsed = (tstop.tv_sec - tstart.tv_sec)
+			+ (tstop.tv_nsec - tstart.tv_nsec) * 1e-9;
+
+	// Report
+	// {{{
+	printf("%lu requests in %lu clocks (%lu clocks when logged), %lu stalls\n",
+		nreq, mem->m_stats.m_clocks, logged_clocks,
+		mem->m_stats.m_stalls);
+	for(int k=0; k<mem->m_stats.m_nsrc; k++) {
+		const MEMSTATS::SOURCE	*s = &mem->m_stats.m_src[k];
+
+		if (!s->m_reads && !s->m_writes)
+			continue;
+		printf("%-12s %10lu reads, %10lu writes, mean latency %.2f\n",
+			s->m_name, s->m_reads, s->m_writes,
+			(s->m_acks) ? s->m_latency_sum / (double)s->m_acks :0.0);
+	}
+	mem->report(stdout);
+	printf("Replayed in %.3f s, %.3f M requests/s\n", elapsed,
+		nreq / elapsed / 1e6);
+
+	if (statfile && !mem->m_stats.dump(statfile))
+		exit(EXIT_FAILURE);
+	// }}}
+
+	delete mem;
+	exit(EXIT_SUCCESS);
+}
@@ -13,6 +13,9 @@
 //	ZipCPU project in that there is a variable delay from request to
 //	completion.
 //
+//	Memory is allocated a page at a time, and then only once a page is
+//	first written.  See memsim.h for details.
+//
 //
 // Creator:	Dan Gisselquist, Ph.D.
 //		Gisselquist Technology, LLC
@@ -49,12 +52,29 @@
 #include <assert.h>
 #include "memsim.h"
 
-MEMSIM::MEMSIM(const unsigned int nwords, const unsigned int delay) {
+const	DDR3TIMING	NEXYS_VIDEO_DDR3 = {
+	9,	// 1k columns of 16-bits each, or 512 32-bit words, per row
+	3,	// 8 banks
+	2,	// tRCD = 13.75ns
+	2,	// tRP  = 13.75ns
+	2,	// tWTR = 7.5ns, plus bus turnaround
+	780,	// tREFI= 7.8us
+	26,	// tRFC = 260ns
+	16,	// Command queue depth
+	true	// Open page policy
+};
+
+MEMSIM::MEMSIM(const unsigned int nwords, const unsigned int delay,
+		const DDR3TIMING *timing) {
 	unsigned int	nxt;
 	for(nxt=1; nxt < nwords; nxt<<=1)
 		;
 	m_len = nxt; m_mask = nxt-1;
-	m_mem = new BUSW[m_len];
+	m_npages = (m_len + PAGE_MASK) >> PAGE_BITS;
+	m_pages  = new BUSW *[m_npages];
+	for(unsigned k=0; k<m_npages; k++)
+		m_pages[k] = NULL;
+	m_resident = 0;
 
 	m_delay = delay;
 	for(m_delay_mask=1; m_delay_mask < delay; m_delay_mask<<=1)
@@ -65,15 +85,85 @@ MEMSIM::MEMSIM(const unsigned int nwords, const unsigned int delay) {
 		m_fifo_ack[i] = 0;
 	m_delay_mask-=1;
 	m_head = 0; m_tail = (m_head - delay)&m_delay_mask;
+
+	// DDR3 timing model
+	// {{{
+	m_timed = (timing != NULL);
+	if (m_timed) {
+		unsigned	nbanks, qlen;
+
+		m_tm = *timing;
+		assert(m_tm.m_depth > 0);
+
+		nbanks = 1u << m_tm.m_bank_bits;
+		m_open_row  = new int[nbanks];
+		m_bank_free = new unsigned long[nbanks];
+
+		// No more than m_depth requests may be waiting to be issued,
+		// and no more than m_delay can be issued and awaiting their
+		// acks, so this is as long as the ack queue ever needs to be
+		for(qlen=1; qlen < m_tm.m_depth + delay + 1; qlen<<=1)
+			;
+		m_qmask  = qlen-1;
+		m_qissue = new unsigned long[qlen];
+		m_qack   = new unsigned long[qlen];
+		m_qdata  = new BUSW[qlen];
+	} else {
+		memset(&m_tm, 0, sizeof(m_tm));
+		m_open_row  = NULL;
+		m_bank_free = NULL;
+		m_qmask  = 0;
+		m_qissue = m_qack = NULL;
+		m_qdata  = NULL;
+	}
+	reset_timing();
+	// }}}
+
+	m_log = NULL;
+	m_log_last = 0;
+}
+
+void	MEMSIM::reset_timing(void) {
+	m_now = 0;
+	m_next_cmd = 0;
+	m_next_refresh = m_tm.m_trefi;
+	m_last_we = false;
+	m_qhead = m_qtail = 0;
+	m_row_hits = m_row_misses = m_row_conflicts = m_refreshes = 0;
+	if (m_timed) {
+		for(unsigned k=0; k < (1u<<m_tm.m_bank_bits); k++) {
+			m_open_row[k]  = -1;
+			m_bank_free[k] = 0;
+		}
+	}
 }
 
 MEMSIM::~MEMSIM(void) {
-	delete[]	m_mem;
+	close_log();
+	clear();
+	delete[]	m_pages;
+	delete[]	m_fifo_ack;
+	delete[]	m_fifo_data;
+	delete[]	m_open_row;
+	delete[]	m_bank_free;
+	delete[]	m_qissue;
+	delete[]	m_qack;
+	delete[]	m_qdata;
+}
+
+void	MEMSIM::clear(void) {
+	for(unsigned k=0; k<m_npages; k++) {
+		delete[] m_pages[k];
+		m_pages[k] = NULL;
+	}
+	m_resident = 0;
 }
 
 void	MEMSIM::load(const char *fname) {
 	FILE	*fp;
-	unsigned int	nr;
+	unsigned int	nr = 0;
+
+	clear();
 
 	fp = fopen(fname, "r");
 	if (!fp) {
@@ -81,9 +171,29 @@ void	MEMSIM::load(const char *fname) {
 			fname);
 		perror("O/S Err:");
 		fprintf(stderr, "\tInitializing memory with zero instead.\n");
-		nr = 0;
 	} else {
-		nr = fread(m_mem, sizeof(BUSW), m_len, fp);
+		BUSW	*buf = new BUSW[PAGE_WORDS];
+
+		// Read a page at a time, only keeping those pages that have
+		// something other than zero within them
+		while(nr < m_len) {
+			unsigned	ln = m_len - nr, k;
+
+			if (ln > PAGE_WORDS)
+				ln = PAGE_WORDS;
+			ln = fread(buf, sizeof(BUSW), ln, fp);
+			if (ln == 0)
+				break;
+
+			for(k=0; k<ln; k++)
+				if (buf[k])
+					break;
+			if (k < ln)
+				memcpy(page(nr), buf, ln * sizeof(BUSW));
+			nr += ln;
+		}
+
+		delete[] buf;
 		fclose(fp);
 
 		if (nr != m_len) {
@@ -92,18 +202,204 @@ void	MEMSIM::load(const char *fname) {
 			fprintf(stderr, "\tFilling the rest with zero.\n");
 		}
 	}
-
-	for(; nr<m_len; nr++)
-		m_mem[nr] = 0l;
 }
 
 void	MEMSIM::load(const unsigned int addr, const char *buf, const size_t len) {
-	memcpy(&m_mem[addr], buf, len);
+	// addr is a word address, len a length in bytes.  Copy a page (or
+	// what's left of one) at a time.
+	const	size_t	PAGE_BYTES = PAGE_WORDS * sizeof(BUSW);
+	size_t	pos = 0;
+
+	while(pos < len) {
+		size_t	a  = (size_t)addr * sizeof(BUSW) + pos,
+			of = a % PAGE_BYTES,
+			ln = PAGE_BYTES - of;
+
+		if (ln > len - pos)
+			ln = len - pos;
+		memcpy(((char *)page(a / sizeof(BUSW))) + of, &buf[pos], ln);
+		pos += ln;
+	}
 }
 
-void	MEMSIM::apply(const uchar wb_cyc, const uchar wb_stb, const uchar wb_we,
-			const BUSW wb_addr, const BUSW wb_data, const uchar wb_sel,
-			unsigned char &o_ack, unsigned char &o_stall, BUSW &o_data) {
+bool	MEMSIM::open_log(const char *fname) {
+	// {{{
+	uint32_t	nsrc;
+
+	close_log();
+	m_log = fopen(fname, "wb");
+	if (!m_log) {
+		fprintf(stderr, "ERR: Could not open %s for writing\n", fname);
+		perror("O/S Err:");
+		return false;
+	}
+
+	nsrc = m_stats.m_nsrc;
+	fwrite(MEMLOG_MAGIC, 1, strlen(MEMLOG_MAGIC), m_log);
+	fwrite(&nsrc, sizeof(nsrc), 1, m_log);
+	for(unsigned k=0; k<nsrc; k++)
+		fwrite(m_stats.m_src[k].m_name, 1, MEMLOG_NAMELEN, m_log);
+	m_log_last = m_stats.m_clocks;
+	return true;
+}
+// }}}
+
+void	MEMSIM::close_log(void) {
+	if (m_log)
+		fclose(m_log);
+	m_log = NULL;
+}
+
+void	MEMSIM::log(const uchar wb_we, const BUSW wb_addr, const BUSW wb_data,
+			const uchar wb_sel, const int tag) {
+	// {{{
+	MEMLOG_REC	rec;
+	unsigned long	delta = m_stats.m_clocks - m_log_last;
+
+	memset(&rec, 0, sizeof(rec));
+	while(delta > 0xffffffffu) {
+		// Long idle periods need their own record(s)
+		rec.m_delta = 0xffffffffu;
+		rec.m_flags = MEMLOG_IDLE;
+		rec.m_tag   = MEMLOG_NOTAG;
+		fwrite(&rec, sizeof(rec), 1, m_log);
+		delta -= 0xffffffffu;
+	}
+
+	rec.m_delta = delta;
+	rec.m_addr  = wb_addr;
+	rec.m_data  = wb_data;
+	rec.m_flags = (wb_we) ? MEMLOG_WE : 0;
+	rec.m_sel   = wb_sel & 0x0f;
+	rec.m_tag   = (tag >= 0 && tag < m_stats.m_nsrc) ? tag : MEMLOG_NOTAG;
+	fwrite(&rec, sizeof(rec), 1, m_log);
+
+	m_log_last = m_stats.m_clocks;
+}
+// }}}
+
+void	MEMSIM::report(FILE *fp) const {
+	fprintf(fp, "MEMSIM: %u of %u pages resident, %.1f of %.1f MiB\n",
+		m_resident, m_npages,
+		resident_bytes() / (double)(1<<20),
+		total_bytes() / (double)(1<<20));
+	if (m_timed)
+		fprintf(fp, "MEMSIM: %lu row hits, %lu misses, %lu conflicts, %lu refreshes\n",
+			m_row_hits, m_row_misses, m_row_conflicts,
+			m_refreshes);
+}
+
+void	MEMSIM::save(FILE *fp) const {
+	BUSW	v[5] = { m_len, m_delay, m_delay_mask, m_head, m_tail };
+	unsigned	last = m_npages;
+
+	fwrite(v, sizeof(v), 1, fp);
+	fwrite(m_fifo_ack,  sizeof(int),  m_delay_mask+1, fp);
+	fwrite(m_fifo_data, sizeof(BUSW), m_delay_mask+1, fp);
+
+	fwrite(&m_timed, sizeof(m_timed), 1, fp);
+	if (m_timed) {
+		unsigned long	t[9] = { m_now, m_next_cmd, m_next_refresh,
+				(m_last_we) ? 1ul:0ul,
+				m_row_hits, m_row_misses, m_row_conflicts,
+				m_refreshes, (m_qhead - m_qtail) & m_qmask };
+
+		fwrite(t, sizeof(t), 1, fp);
+		fwrite(m_open_row,  sizeof(int), 1u<<m_tm.m_bank_bits, fp);
+		fwrite(m_bank_free, sizeof(unsigned long),
+					1u<<m_tm.m_bank_bits, fp);
+		for(unsigned k=m_qtail; k != m_qhead; k = (k+1)&m_qmask) {
+			fwrite(&m_qissue[k], sizeof(unsigned long), 1, fp);
+			fwrite(&m_qack[k],   sizeof(unsigned long), 1, fp);
+			fwrite(&m_qdata[k],  sizeof(BUSW), 1, fp);
+		}
+	}
+
+	// Only those pages that have been touched are saved, each preceded
+	// by its page number.  The list ends with m_npages.
+	for(unsigned k=0; k<m_npages; k++) {
+		if (!m_pages[k])
+			continue;
+		fwrite(&k, sizeof(k), 1, fp);
+		fwrite(m_pages[k], sizeof(BUSW), PAGE_WORDS, fp);
+	}
+	fwrite(&last, sizeof(last), 1, fp);
+}
+
+bool	MEMSIM::restore(FILE *fp) {
+	BUSW	v[5];
+	unsigned	pg;
+
+	if (fread(v, sizeof(v), 1, fp) != 1)
+		return false;
+	if ((v[0] != m_len)||(v[1] != m_delay)||(v[2] != m_delay_mask)) {
+		fprintf(stderr, "MEMSIM: Snapshot doesn't match this memory\n");
+		return false;
+	}
+
+	m_head = v[3];
+	m_tail = v[4];
+
+	if (fread(m_fifo_ack, sizeof(int), m_delay_mask+1, fp)
+						!= m_delay_mask+1)
+		return false;
+	if (fread(m_fifo_data, sizeof(BUSW), m_delay_mask+1, fp)
+						!= m_delay_mask+1)
+		return false;
+
+	// The timing model
+	// {{{
+	bool	timed;
+	if (fread(&timed, sizeof(timed), 1, fp) != 1)
+		return false;
+	if (timed != m_timed) {
+		fprintf(stderr, "MEMSIM: Snapshot %s the DDR3 timing model\n",
+			(timed) ? "uses" : "doesn't use");
+		return false;
+	}
+
+	if (m_timed) {
+		unsigned long	t[9];
+		unsigned	nbanks = 1u<<m_tm.m_bank_bits;
+
+		if (fread(t, sizeof(t), 1, fp) != 1)
+			return false;
+		m_now = t[0]; m_next_cmd = t[1]; m_next_refresh = t[2];
+		m_last_we = (t[3] != 0);
+		m_row_hits = t[4]; m_row_misses = t[5];
+		m_row_conflicts = t[6]; m_refreshes = t[7];
+		if (t[8] > m_qmask)
+			return false;
+		if (fread(m_open_row, sizeof(int), nbanks, fp) != nbanks)
+			return false;
+		if (fread(m_bank_free, sizeof(unsigned long), nbanks, fp)
+						!= nbanks)
+			return false;
+		m_qtail = 0;
+		for(m_qhead=0; m_qhead < t[8]; m_qhead++) {
+			if (fread(&m_qissue[m_qhead], sizeof(unsigned long), 1, fp) != 1
+				|| fread(&m_qack[m_qhead], sizeof(unsigned long), 1, fp) != 1
+				|| fread(&m_qdata[m_qhead], sizeof(BUSW), 1, fp) != 1)
+				return false;
+		}
+	}
+	// }}}
+
+	clear();
+	while(1) {
+		if (fread(&pg, sizeof(pg), 1, fp) != 1)
+			return false;
+		if (pg >= m_npages)
+			break;
+		if (fread(page(pg << PAGE_BITS), sizeof(BUSW), PAGE_WORDS, fp)
+						!= PAGE_WORDS)
+			return false;
+	}
+	return true;
+}
+
+void	MEMSIM::write(const BUSW wb_addr, const BUSW wb_data, const uchar wb_sel) {
+	BUSW	&memv = (*this)[wb_addr];
 	unsigned	sel = 0;
 
 	if (wb_sel&0x8)
@@ -114,6 +410,30 @@ void	MEMSIM::apply(const uchar wb_cyc, const uchar wb_stb, const uchar wb_we,
 		sel |= 0x00000ff00;
 	if (wb_sel&0x1)
 		sel |= 0x0000000ff;
+
+	if (sel == 0xffffffffu)
+		memv = wb_data;
+	else {
+		memv &= ~sel;
+		memv |= (wb_data & sel);
+	}
+}
+
+void	MEMSIM::apply(const uchar wb_cyc, const uchar wb_stb, const uchar wb_we,
+			const BUSW wb_addr, const BUSW wb_data, const uchar wb_sel,
+			unsigned char &o_ack, unsigned char &o_stall, BUSW &o_data,
+			const int tag) {
+	if (m_timed) {
+		apply_timed(wb_cyc, wb_stb, wb_we, wb_addr, wb_data, wb_sel,
+			o_ack, o_stall, o_data);
+		m_stats.clock(wb_cyc, wb_stb, wb_we, wb_addr, wb_sel,
+			o_ack, o_stall, tag);
+		if (m_log && wb_cyc && wb_stb && !o_stall)
+			log(wb_we, wb_addr, (wb_we) ? wb_data : peek(wb_addr),
+				wb_sel, tag);
+		return;
+	}
+
 	m_head++; m_tail = (m_head - m_delay)&m_delay_mask;
 	m_head&=m_delay_mask;
 	o_ack = m_fifo_ack[m_tail];
@@ -124,27 +444,25 @@ void	MEMSIM::apply(const uchar wb_cyc, const uchar wb_stb, const uchar wb_we,
 
 	o_stall= 0;
 	if ((wb_cyc)&&(wb_stb)) {
-		if (wb_we) {
-			if (sel == 0xffffffffu)
-				m_mem[wb_addr & m_mask] = wb_data;
-			else {
-				uint32_t memv = m_mem[wb_addr & m_mask];
-				memv &= ~sel;
-				memv |= (wb_data & sel);
-				m_mem[wb_addr & m_mask] = memv;
-			}
-		}
+		if (wb_we)
+			write(wb_addr, wb_data, wb_sel);
 		m_fifo_ack[m_head] = 1;
-		m_fifo_data[m_head] = m_mem[wb_addr & m_mask];
+		m_fifo_data[m_head] = peek(wb_addr);
 #ifdef	DEBUG
 		printf("MEMBUS %s[%08x] = %08x\n",
 			(wb_we)?"W":"R",
 			wb_addr&m_mask,
-			m_mem[wb_addr&m_mask]);
+			peek(wb_addr));
 #endif
 		// o_ack  = 1;
 	}
 
+	m_stats.clock(wb_cyc, wb_stb, wb_we, wb_addr, wb_sel,
+		o_ack, o_stall, tag);
+	if (m_log && wb_cyc && wb_stb)
+		log(wb_we, wb_addr, (wb_we) ? wb_data : peek(wb_addr),
+			wb_sel, tag);
+
 #ifdef	DEBUG
 	if (o_ack) {
 		printf("MEMBUS -- ACK %s 0x%08x - 0x%08x\n",
@@ -154,4 +472,115 @@ void	MEMSIM::apply(const uchar wb_cyc, const uchar wb_stb, const uchar wb_we,
 #endif
 }
 
+unsigned long	MEMSIM::schedule(const BUSW wb_addr, const bool wb_we) {
+	unsigned	bank, nbanks = 1u << m_tm.m_bank_bits;
+	int		row;
+	unsigned long	ready, issue;
+
+	bank = (wb_addr >> m_tm.m_col_bits) & (nbanks-1);
+	row  = (wb_addr & m_mask) >> (m_tm.m_col_bits + m_tm.m_bank_bits);
+
+	// Refresh
+	// {{{
+	// Every tREFI, all banks are precharged and then refreshed.  Nothing
+	// may be issued until tRFC after that.  We only check for refreshes
+	// here, as requests arrive, so a refresh might be charged to a request
+	// a little earlier, or later, than it would be in hardware.
+	issue = (m_next_cmd > m_now) ? m_next_cmd : m_now;
+	while(issue >= m_next_refresh) {
+		unsigned long	done = m_next_refresh + m_tm.m_trp
+						+ m_tm.m_trfc;
+
+		for(unsigned k=0; k<nbanks; k++) {
+			m_open_row[k] = -1;
+			if (m_bank_free[k] < done)
+				m_bank_free[k] = done;
+		}
+		if (m_next_cmd < done)
+			m_next_cmd = done;
+		m_next_refresh += m_tm.m_trefi;
+		m_refreshes++;
+	}
+	// }}}
+
+	// Row activation
+	// {{{
+	// The controller can look ahead into its queue, and so open a row
+	// in one bank while still issuing reads or writes to another.  Hence
+	// the activate only needs to wait on the bank, not the whole SDRAM.
+	if (m_open_row[bank] == row) {
+		ready = m_now;
+		m_row_hits++;
+	} else {
+		ready = (m_bank_free[bank] > m_now) ? m_bank_free[bank] : m_now;
+		if (m_open_row[bank] >= 0) {
+			ready += m_tm.m_trp;
+			m_row_conflicts++;
+		} else
+			m_row_misses++;
+		ready += m_tm.m_trcd;
+	}
+	m_open_row[bank] = (m_tm.m_open_page) ? row : -1;
+	// }}}
+
+	// Read/write command
+	// {{{
+	issue = m_next_cmd;
+	if (wb_we != m_last_we)
+		issue += m_tm.m_twtr;
+	if (issue < ready)
+		issue = ready;
+	if (issue < m_now)
+		issue = m_now;
+
+	m_last_we = wb_we;
+	m_next_cmd = issue+1;
+	m_bank_free[bank] = issue+1;
+	// }}}
 
+	return issue;
+}
+
+void	MEMSIM::apply_timed(const uchar wb_cyc, const uchar wb_stb,
+			const uchar wb_we,
+			const BUSW wb_addr, const BUSW wb_data,
+			const uchar wb_sel,
+			uchar &o_ack, uchar &o_stall, BUSW &o_data) {
+	unsigned	waiting = 0;
+
+	m_now++;
+
+	// Acknowledge the oldest request, if it's ready.  Since requests are
+	// issued in order, at most one per clock, they are also acknowledged
+	// in order no more than one per clock.
+	o_ack  = 0;
+	o_data = 0;
+	if ((m_qtail != m_qhead)&&(m_qack[m_qtail] <= m_now)) {
+		o_ack  = 1;
+		o_data = m_qdata[m_qtail];
+		m_qtail = (m_qtail + 1) & m_qmask;
+	}
+
+	// Count the requests still waiting to be issued to the SDRAM.  These
+	// are the ones occupying the command queue.
+	for(unsigned k=m_qhead; k != m_qtail; ) {
+		k = (k - 1) & m_qmask;
+		if (m_qissue[k] <= m_now)
+			break;
+		waiting++;
+	}
+
+	o_stall = (waiting >= m_tm.m_depth);
+	if ((wb_cyc)&&(wb_stb)&&(!o_stall)) {
+		unsigned long	issue = schedule(wb_addr, wb_we);
+
+		if (wb_we)
+			write(wb_addr, wb_data, wb_sel);
+
+		m_qissue[m_qhead] = issue;
+		m_qack[m_qhead]   = issue + m_delay;
+		m_qdata[m_qhead]  = peek(wb_addr);
+		m_qhead = (m_qhead + 1) & m_qmask;
+		assert(m_qhead != m_qtail);
+	}
+}
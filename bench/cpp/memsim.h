@@ -13,6 +13,19 @@
 //	ZipCPU project in that there is a variable delay from request to
 //	completion.
 //
+//	Memory is allocated a page at a time, and then only once a page is
+//	first written.  Reads from pages that have never been written return
+//	zero.  Hence a large, but mostly unused, memory costs (almost) nothing
+//	on the host.
+//
+//	Given a DDR3TIMING structure at construction, the memory also (roughly)
+//	models the timing of a DDR3 SDRAM behind a memory controller: banks
+//	with open rows, activate and precharge penalties, bus turnaround
+//	between reads and writes, periodic refresh, and a command queue of
+//	limited depth.  Once the queue fills, the bus is stalled.  Without
+//	this structure, every request is accepted immediately and acknowledged
+//	a fixed delay later.
+//
 //
 // Creator:	Dan Gisselquist, Ph.D.
 //		Gisselquist Technology, LLC
@@ -46,33 +59,150 @@
 #ifndef	MEMSIM_H
 #define	MEMSIM_H
 
+#include <stdio.h>
+#include "memstats.h"
+#include "memlog.h"
+
+// DDR3TIMING
+// {{{
+// Parameters for the DDR3 timing model.  All times are in bus clocks.
+typedef	struct	DDR3TIMING_S {
+	unsigned	m_col_bits,	// log_2 of the (bus) words per row
+			m_bank_bits,	// log_2 of the number of banks
+			m_trcd,		// Activate to read/write
+			m_trp,		// Precharge to activate
+			m_twtr,		// Turnaround, read to write or back
+			m_trefi,	// Average refresh interval
+			m_trfc,		// Refresh to activate
+			m_depth;	// Command queue depth
+	bool		m_open_page;	// Leave rows open after an access
+} DDR3TIMING;
+
+// The MT41K256M16 on the Nexys Video board, 8 banks of 2kB rows, as seen
+// from a 100MHz, 32-bit bus
+extern	const	DDR3TIMING	NEXYS_VIDEO_DDR3;
+// }}}
+
 class	MEMSIM {
 public:
 	typedef	unsigned int	BUSW;
 	typedef	unsigned char	uchar;
 
-	BUSW	*m_mem, m_len, m_mask, m_head, m_tail, m_delay_mask, m_delay;
+	// Words per page: 4k words, or 16kB, per page
+	static	const	unsigned	PAGE_BITS = 12,
+				PAGE_WORDS = (1u << PAGE_BITS),
+				PAGE_MASK  = PAGE_WORDS-1;
+
+	BUSW	**m_pages, m_len, m_mask, m_head, m_tail, m_delay_mask, m_delay;
+	unsigned	m_npages, m_resident;
 	int	*m_fifo_ack;
 	BUSW	*m_fifo_data;
 
+	// DDR3 timing model state
+	// {{{
+	bool		m_timed;
+	DDR3TIMING	m_tm;
+	unsigned long	m_now, m_next_cmd, m_next_refresh;
+	int		*m_open_row;
+	unsigned long	*m_bank_free;
+	bool		m_last_we;
+
+	// Requests accepted, but not yet acknowledged
+	unsigned	m_qmask, m_qhead, m_qtail;
+	unsigned long	*m_qissue, *m_qack;
+	BUSW		*m_qdata;
+
+	unsigned long	m_row_hits, m_row_misses, m_row_conflicts, m_refreshes;
+	// }}}
+
+	// Bus statistics.  Requests may be attributed to a source by passing
+	// its tag (from m_stats.add_source()) to apply().
+	MEMSTATS	m_stats;
 
-	MEMSIM(const unsigned int nwords, const unsigned int delay=27);
+	// Transaction log, if open
+	FILE		*m_log;
+	unsigned long	m_log_last;
+
+	MEMSIM(const unsigned int nwords, const unsigned int delay=27,
+			const DDR3TIMING *timing = NULL);
 	~MEMSIM(void);
 	void	load(const char *fname);
 	void	load(const unsigned int addr, const char *buf,const size_t len);
+	// Checkpoint support: the memory contents and any pending acks
+	void	save(FILE *fp) const;
+	bool	restore(FILE *fp);
 	void	apply(const uchar wb_cyc, const uchar wb_stb,
 				const uchar wb_we,
 			const BUSW wb_addr, const BUSW wb_data,
 				const uchar wb_sel,
+			uchar &o_ack, uchar &o_stall, BUSW &o_data,
+			const int tag = -1);
+	void	apply_timed(const uchar wb_cyc, const uchar wb_stb,
+				const uchar wb_we,
+			const BUSW wb_addr, const BUSW wb_data,
+				const uchar wb_sel,
 			uchar &o_ack, uchar &o_stall, BUSW &o_data);
+	// Returns the bus clock when a new request may be issued to the SDRAM
+	unsigned long	schedule(const BUSW wb_addr, const bool wb_we);
+	void	reset_timing(void);
+	// Logs every request accepted from now on to fname.  See memlog.h.
+	bool	open_log(const char *fname);
+	void	close_log(void);
+	void	log(const uchar wb_we, const BUSW wb_addr, const BUSW wb_data,
+			const uchar wb_sel, const int tag);
+	// Writes those bytes of wb_data selected by wb_sel into memory
+	void	write(const BUSW wb_addr, const BUSW wb_data, const uchar wb_sel);
 	void	operator()(const uchar wb_cyc, const uchar wb_stb,
 				const uchar wb_we,
 			const BUSW wb_addr, const BUSW wb_data,
 				const uchar wb_sel,
-			uchar &o_ack, uchar &o_stall, BUSW &o_data) {
-		apply(wb_cyc, wb_stb, wb_we, wb_addr, wb_data, wb_sel, o_ack, o_stall, o_data);
+			uchar &o_ack, uchar &o_stall, BUSW &o_data,
+			const int tag = -1) {
+		apply(wb_cyc, wb_stb, wb_we, wb_addr, wb_data, wb_sel, o_ack, o_stall, o_data, tag);
+	}
+
+	// page()
+	// {{{
+	// Returns the page containing addr, allocating (and zeroing) it
+	// first if it has never been touched before
+	BUSW	*page(const BUSW addr) {
+		unsigned	pg = (addr & m_mask) >> PAGE_BITS;
+
+		if (!m_pages[pg]) {
+			m_pages[pg] = new BUSW[PAGE_WORDS]();
+			m_resident++;
+		}
+		return m_pages[pg];
+	}
+	// }}}
+
+	// peek()
+	// {{{
+	// Reads a word from memory without allocating anything
+	BUSW	peek(const BUSW addr) const {
+		const BUSW	*pg = m_pages[(addr & m_mask) >> PAGE_BITS];
+
+		return (pg) ? pg[addr & PAGE_MASK] : 0;
 	}
-	BUSW &operator[](const BUSW addr) { return m_mem[addr&m_mask]; }
+	// }}}
+
+	// Releases every page, returning the memory to all zeros
+	void	clear(void);
+
+	BUSW &operator[](const BUSW addr) {
+		return page(addr)[addr & PAGE_MASK];
+	}
+
+	// The number of pages, and bytes, of host memory actually in use
+	unsigned	resident_pages(void) const { return m_resident; }
+	size_t	resident_bytes(void) const {
+		return (size_t)m_resident * PAGE_WORDS * sizeof(BUSW);
+	}
+	size_t	total_bytes(void) const {
+		return (size_t)m_len * sizeof(BUSW);
+	}
+
+	void	report(FILE *fp) const;
 };
 
 #endif
@@ -0,0 +1,295 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/memstats.cpp
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Counts the requests, stalls, and acknowledgments on a memory's
+//		Wishbone bus, and writes them out when asked to.  See
+//	memstats.h for details.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "memstats.h"
+
+MEMSTATS::MEMSTATS(void) {
+	m_nsrc = 0;
+	m_frames = NULL;
+	m_frames_alloc = 0;
+	m_clock_hz = 100e6;
+	add_source("other");
+	reset();
+}
+
+MEMSTATS::~MEMSTATS(void) {
+	free(m_frames);
+}
+
+void	MEMSTATS::reset(void) {
+	// {{{
+	for(int k=0; k<m_nsrc; k++) {
+		SOURCE	*s = &m_src[k];
+
+		s->m_reads  = s->m_writes = 0;
+		s->m_rbytes = s->m_wbytes = 0;
+		s->m_acks   = s->m_latency_sum = 0;
+		memset(s->m_latency, 0, sizeof(s->m_latency));
+	}
+
+	m_clocks = m_busy = m_stalls = 0;
+	memset(m_sel, 0, sizeof(m_sel));
+	m_fifo_head = m_fifo_tail = 0;
+
+	m_nframes = 0;
+	memset(&m_this_frame, 0, sizeof(m_this_frame));
+}
+// }}}
+
+int	MEMSTATS::add_source(const char *name, BUSW lo, BUSW hi) {
+	// {{{
+	SOURCE	*s;
+
+	assert(m_nsrc < MAX_SOURCES);
+	s = &m_src[m_nsrc];
+	memset(s, 0, sizeof(SOURCE));
+	strncpy(s->m_name, name, sizeof(s->m_name)-1);
+	s->m_lo = lo;
+	s->m_hi = hi;
+	s->m_ranged = (lo <= hi);
+
+	return m_nsrc++;
+}
+// }}}
+
+void	MEMSTATS::request(const uchar wb_we, const BUSW wb_addr,
+			const uchar wb_sel, const int tag) {
+	// {{{
+	int		src = 0;
+	unsigned	nbytes;
+	SOURCE		*s;
+
+	if ((tag >= 0)&&(tag < m_nsrc))
+		src = tag;
+	else for(int k=1; k<m_nsrc; k++) {
+		if (m_src[k].m_ranged && wb_addr >= m_src[k].m_lo
+					&& wb_addr <= m_src[k].m_hi) {
+			src = k;
+			break;
+		}
+	}
+
+	s = &m_src[src];
+	m_sel[wb_sel & 0x0f]++;
+	if (wb_we) {
+		nbytes = ((wb_sel & 1) ? 1:0) + ((wb_sel & 2) ? 1:0)
+			+ ((wb_sel & 4) ? 1:0) + ((wb_sel & 8) ? 1:0);
+		s->m_writes++;
+		s->m_wbytes += nbytes;
+		m_this_frame.m_wbytes[src] += nbytes;
+	} else {
+		s->m_reads++;
+		s->m_rbytes += 4;
+		m_this_frame.m_rbytes[src] += 4;
+	}
+
+	m_fifo_time[m_fifo_head] = m_clocks;
+	m_fifo_src[ m_fifo_head] = src;
+	m_fifo_head = (m_fifo_head + 1) % FIFOLN;
+	assert(m_fifo_head != m_fifo_tail);
+}
+// }}}
+
+void	MEMSTATS::ack(void) {
+	// {{{
+	unsigned long	lat;
+	SOURCE		*s;
+
+	// Acks for requests made before we started counting (i.e. before a
+	// snapshot was restored) are ignored
+	if (m_fifo_head == m_fifo_tail)
+		return;
+
+	lat = m_clocks - m_fifo_time[m_fifo_tail];
+	s   = &m_src[m_fifo_src[m_fifo_tail]];
+	m_fifo_tail = (m_fifo_tail + 1) % FIFOLN;
+
+	s->m_acks++;
+	s->m_latency_sum += lat;
+	s->m_latency[(lat < NLATENCY) ? lat : NLATENCY-1]++;
+}
+// }}}
+
+void	MEMSTATS::frame(void) {
+	// {{{
+	if (m_nframes >= m_frames_alloc) {
+		m_frames_alloc = (m_frames_alloc) ? 2*m_frames_alloc : 256;
+		m_frames = (FRAME *)realloc(m_frames,
+					m_frames_alloc * sizeof(FRAME));
+		assert(m_frames);
+	}
+
+	m_frames[m_nframes++] = m_this_frame;
+	memset(&m_this_frame, 0, sizeof(m_this_frame));
+}
+// }}}
+
+bool	MEMSTATS::dump(const char *fname) const {
+	// {{{
+	FILE	*fp;
+	size_t	ln = strlen(fname);
+
+	fp = fopen(fname, "w");
+	if (!fp) {
+		fprintf(stderr, "ERR: Could not open %s for writing\n", fname);
+		perror("O/S Err:");
+		return false;
+	}
+
+	if (ln > 5 && strcmp(&fname[ln-5], ".json") == 0)
+		write_json(fp);
+	else
+		write_csv(fp);
+	fclose(fp);
+	return true;
+}
+// }}}
+
+void	MEMSTATS::write_csv(FILE *fp) const {
+	// {{{
+	// One number per line, in "long" form:
+	//	record,source,key,value
+	fprintf(fp, "record,source,key,value\n");
+	fprintf(fp, "bus,all,clocks,%lu\n", m_clocks);
+	fprintf(fp, "bus,all,busy,%lu\n", m_busy);
+	fprintf(fp, "bus,all,stalls,%lu\n", m_stalls);
+	fprintf(fp, "bus,all,clock_hz,%.0f\n", m_clock_hz);
+	for(int k=0; k<16; k++)
+		if (m_sel[k])
+			fprintf(fp, "sel,all,%x,%lu\n", k, m_sel[k]);
+
+	for(int k=0; k<m_nsrc; k++) {
+		const SOURCE	*s = &m_src[k];
+
+		fprintf(fp, "source,%s,reads,%lu\n",  s->m_name, s->m_reads);
+		fprintf(fp, "source,%s,writes,%lu\n", s->m_name, s->m_writes);
+		fprintf(fp, "source,%s,rbytes,%lu\n", s->m_name, s->m_rbytes);
+		fprintf(fp, "source,%s,wbytes,%lu\n", s->m_name, s->m_wbytes);
+		fprintf(fp, "source,%s,acks,%lu\n",   s->m_name, s->m_acks);
+		fprintf(fp, "source,%s,mean_latency,%.3f\n", s->m_name,
+			(s->m_acks) ? s->m_latency_sum / (double)s->m_acks:0.0);
+		for(int b=0; b<NLATENCY; b++)
+			if (s->m_latency[b])
+				fprintf(fp, "latency,%s,%d,%lu\n", s->m_name,
+					b, s->m_latency[b]);
+	}
+
+	for(unsigned f=0; f<m_nframes; f++) {
+		const FRAME	*fr = &m_frames[f];
+		double		secs = fr->m_clocks / m_clock_hz;
+
+		fprintf(fp, "frame%u,all,clocks,%lu\n", f, fr->m_clocks);
+		fprintf(fp, "frame%u,all,stalls,%lu\n", f, fr->m_stalls);
+		for(int k=0; k<m_nsrc; k++) {
+			fprintf(fp, "frame%u,%s,rbytes,%lu\n", f,
+				m_src[k].m_name, fr->m_rbytes[k]);
+			fprintf(fp, "frame%u,%s,wbytes,%lu\n", f,
+				m_src[k].m_name, fr->m_wbytes[k]);
+			fprintf(fp, "frame%u,%s,MBps,%.3f\n", f,
+				m_src[k].m_name, (secs > 0) ?
+				(fr->m_rbytes[k]+fr->m_wbytes[k])/secs/1e6 :0.0);
+		}
+	}
+}
+// }}}
+
+void	MEMSTATS::write_json(FILE *fp) const {
+	// {{{
+	fprintf(fp, "{\n");
+	fprintf(fp, "  \"clocks\": %lu,\n", m_clocks);
+	fprintf(fp, "  \"busy\": %lu,\n", m_busy);
+	fprintf(fp, "  \"stalls\": %lu,\n", m_stalls);
+	fprintf(fp, "  \"clock_hz\": %.0f,\n", m_clock_hz);
+
+	fprintf(fp, "  \"sel\": {");
+	for(int k=0; k<16; k++)
+		fprintf(fp, "%s\"%x\": %lu", (k) ? ", ":" ", k, m_sel[k]);
+	fprintf(fp, " },\n");
+
+	fprintf(fp, "  \"sources\": {\n");
+	for(int k=0; k<m_nsrc; k++) {
+		const SOURCE	*s = &m_src[k];
+		bool		first = true;
+
+		fprintf(fp, "    \"%s\": {\n", s->m_name);
+		fprintf(fp, "      \"reads\": %lu, \"writes\": %lu,\n",
+			s->m_reads, s->m_writes);
+		fprintf(fp, "      \"rbytes\": %lu, \"wbytes\": %lu,\n",
+			s->m_rbytes, s->m_wbytes);
+		fprintf(fp, "      \"acks\": %lu, \"mean_latency\": %.3f,\n",
+			s->m_acks, (s->m_acks)
+				? s->m_latency_sum / (double)s->m_acks : 0.0);
+		fprintf(fp, "      \"latency\": {");
+		for(int b=0; b<NLATENCY; b++) {
+			if (!s->m_latency[b])
+				continue;
+			fprintf(fp, "%s\"%d\": %lu", (first) ? " ":", ",
+				b, s->m_latency[b]);
+			first = false;
+		}
+		fprintf(fp, " }\n    }%s\n", (k+1 < m_nsrc) ? ",":"");
+	}
+	fprintf(fp, "  },\n");
+
+	fprintf(fp, "  \"frames\": [\n");
+	for(unsigned f=0; f<m_nframes; f++) {
+		const FRAME	*fr = &m_frames[f];
+		double		secs = fr->m_clocks / m_clock_hz;
+		unsigned long	total = 0;
+
+		fprintf(fp, "    { \"clocks\": %lu, \"stalls\": %lu",
+			fr->m_clocks, fr->m_stalls);
+		for(int k=0; k<m_nsrc; k++) {
+			fprintf(fp, ", \"%s\": { \"rbytes\": %lu, \"wbytes\": %lu }",
+				m_src[k].m_name, fr->m_rbytes[k],
+				fr->m_wbytes[k]);
+			total += fr->m_rbytes[k] + fr->m_wbytes[k];
+		}
+		fprintf(fp, ", \"MBps\": %.3f }%s\n",
+			(secs > 0) ? total / secs / 1e6 : 0.0,
+			(f+1 < m_nframes) ? ",":"");
+	}
+	fprintf(fp, "  ]\n}\n");
+}
+// }}}
@@ -0,0 +1,147 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/memstats.h
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Counts what takes place on a memory's Wishbone bus: reads and
+//		writes, byte select usage, stall cycles, and the latency
+//	from request to acknowledgment.  Requests may be attributed to separate
+//	sources (i.e. the frame writer, or the video reader), either by tag or
+//	by address.  Counts are also kept for every video frame, so that the
+//	bandwidth used per frame may be found.  Everything may then be written
+//	out, either as CSV or as JSON.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#ifndef	MEMSTATS_H
+#define	MEMSTATS_H
+
+#include <stdio.h>
+
+class	MEMSTATS {
+public:
+	typedef	unsigned int	BUSW;
+	typedef	unsigned char	uchar;
+
+	static	const	int	MAX_SOURCES = 8,
+				NLATENCY = 256,	// Latency histogram bins
+				FIFOLN = 1024;	// Max requests in flight
+
+	// SOURCE
+	// {{{
+	// Requests are attributed to a source either by tag, or (if untagged)
+	// by the first source whose address range [m_lo, m_hi] contains
+	// them.  Source zero, "other", collects everything else.
+	typedef	struct	SOURCE_S {
+		char		m_name[32];
+		BUSW		m_lo, m_hi;
+		bool		m_ranged;
+		unsigned long	m_reads, m_writes, m_rbytes, m_wbytes,
+				m_acks, m_latency_sum,
+				m_latency[NLATENCY];
+	} SOURCE;
+	// }}}
+
+	// FRAME
+	// {{{
+	// Counts for one video frame, used to calculate bandwidth per frame
+	typedef	struct	FRAME_S {
+		unsigned long	m_clocks, m_stalls,
+				m_rbytes[MAX_SOURCES], m_wbytes[MAX_SOURCES];
+	} FRAME;
+	// }}}
+
+	SOURCE		m_src[MAX_SOURCES];
+	int		m_nsrc;
+	unsigned long	m_clocks, m_busy, m_stalls, m_sel[16];
+	double		m_clock_hz;
+
+	// Requests waiting on their acks: when they were made, and by whom
+	unsigned long	m_fifo_time[FIFOLN];
+	int		m_fifo_src[FIFOLN];
+	unsigned	m_fifo_head, m_fifo_tail;
+
+	FRAME		*m_frames, m_this_frame;
+	unsigned	m_nframes, m_frames_alloc;
+
+	MEMSTATS(void);
+	~MEMSTATS(void);
+
+	// Starts counting over again from zero, keeping the sources
+	void	reset(void);
+
+	// Adds a new source, returning the tag for it.  If lo <= hi, untagged
+	// requests to addresses within [lo, hi] will also be charged to it.
+	int	add_source(const char *name, BUSW lo = 1, BUSW hi = 0);
+
+	void	set_clock_hz(double hz) { m_clock_hz = hz; }
+
+	// clock()
+	// {{{
+	// Called once per bus clock, with the bus as the memory saw it and
+	// the memory's response
+	void	clock(const uchar wb_cyc, const uchar wb_stb, const uchar wb_we,
+			const BUSW wb_addr, const uchar wb_sel,
+			const uchar o_ack, const uchar o_stall, const int tag) {
+		m_clocks++;
+		m_this_frame.m_clocks++;
+
+		if (o_ack)
+			ack();
+
+		if (!wb_cyc)
+			return;
+		m_busy++;
+		if (!wb_stb)
+			return;
+		if (o_stall) {
+			m_stalls++;
+			m_this_frame.m_stalls++;
+		} else
+			request(wb_we, wb_addr, wb_sel, tag);
+	}
+	// }}}
+
+	void	request(const uchar wb_we, const BUSW wb_addr,
+			const uchar wb_sel, const int tag);
+	void	ack(void);
+
+	// Closes out one frame, and starts counting the next
+	void	frame(void);
+
+	// Writes everything counted so far to a file.  If the file name ends
+	// in .json the file will be JSON, otherwise CSV.
+	bool	dump(const char *fname) const;
+	void	write_csv(FILE *fp) const;
+	void	write_json(FILE *fp) const;
+};
+
+#endif
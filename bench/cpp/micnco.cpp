@@ -36,30 +36,40 @@
 //
 // }}}
 #include <stdio.h>
-#include <math.h>
 #include <assert.h>
 #include "micnco.h"
 
-#define	ADC_BITS	12
-MICNCO::MICNCO() {
-	m_phase = 0;
-	m_step = 1;
+MICNCO::MICNCO(bool debug) {
+	m_ticks = 0;
+	m_state = 0;
+	m_oreg  = 0;
 	m_last_sck = 1;
 	m_bomb = false;
+	m_debug = debug;
+	m_last_oreg = 0;
+	m_stim = &m_chirp;
 
-	double	initial_step = 1.0/23/1024.0;
-	initial_step *= (1<<30)*4.;
-	m_step = (unsigned)initial_step;
+	if (m_debug)
+		printf("MICNCO: STEP:DSTEP = 0x%08x:%08x\n",
+			m_chirp.m_step, m_chirp.m_dstep);
+}
+
+void	MICNCO::step(unsigned s) { m_chirp.step(s); }
+
+void	MICNCO::stimulus(STIMULUS *s) { m_stim = (s) ? s : &m_chirp; }
 
-	double	initial_sweep = 1.0/23./1024.0;
-	initial_sweep *= initial_sweep;
-	initial_sweep *= (1<<30)*4.;
-	m_dstep = (unsigned)initial_sweep;
+int	MICNCO::adc_word(void) {
+	return adc_word(m_stim->sample());
+}
+
+int	MICNCO::adc_word(int sample) {
+	int	v = sample & ((1<<ADC_BITS)-1);
 
-printf("MICNCO: STEP:DSTEP = 0x%08x:%08x\n", m_step, m_dstep);
+	if (v < (1<<((ADC_BITS-1)-3)))
+		v +=2;
+	return v;
 }
 
-void	MICNCO::step(unsigned s) { m_step = s; }
 int MICNCO::operator()(int sck, int csn) {
 	int	ov;
 
@@ -83,26 +93,10 @@ int MICNCO::operator()(int sck, int csn) {
 			m_ticks = 0;
 			m_state++;
 			if (m_state == 5) {
-				m_phase += m_step;
-				m_step  += m_dstep;
-
-				double	cv;
-				cv = cos(2.0*M_PI*m_phase/(1<<30)/4.);
-				cv *= (1<<(ADC_BITS-1));
-				if (cv >= (1<<(ADC_BITS-1)))
-					cv = (1<<(ADC_BITS-1))-1.0;
-				else if (cv < -(1<<(ADC_BITS-1)))
-					cv = -(1<<(ADC_BITS-1));
-				m_oreg = ((int)(cv))&((1<<ADC_BITS)-1);
-				if (m_oreg < (1<<(ADC_BITS-1)-3))
-					m_oreg +=2;
-				if (false) {
-					static int lastoreg = 0;
-					if (lastoreg != m_oreg) {
-						lastoreg = m_oreg;
-						printf("MICNCO: V = %02x\n",
-							m_oreg);
-					}
+				m_oreg = adc_word();
+				if (m_debug && m_last_oreg != m_oreg) {
+					m_last_oreg = m_oreg;
+					printf("MICNCO: V = %02x\n", m_oreg);
 				}
 			} else
 				m_oreg <<= 1;
@@ -112,3 +106,25 @@ int MICNCO::operator()(int sck, int csn) {
 	return ov;
 }
 
+void	MICNCO::save(FILE *fp) const {
+	unsigned	v[2] = { m_ticks, m_state };
+	int		i[3] = { m_last_sck, m_oreg, (m_bomb) ? 1:0 };
+
+	fwrite(v, sizeof(v), 1, fp);
+	fwrite(i, sizeof(i), 1, fp);
+	m_stim->save(fp);
+}
+
+bool	MICNCO::restore(FILE *fp) {
+	unsigned	v[2];
+	int		i[3];
+
+	if (fread(v, sizeof(v), 1, fp) != 1)
+		return false;
+	if (fread(i, sizeof(i), 1, fp) != 1)
+		return false;
+
+	m_ticks = v[0]; m_state = v[1];
+	m_last_sck = i[0]; m_oreg = i[1]; m_bomb = (i[2] != 0);
+	return m_stim->restore(fp);
+}
@@ -7,6 +7,9 @@
 // Purpose:	To define the class that will provide a simulated A/D input for
 //		testing
 //
+//	The samples themselves come from a STIMULUS (stimulus.h).  By default,
+//	this is the chirp MICNCO has always produced, to within an LSB.
+//
 // Creator:	Dan Gisselquist, Ph.D.
 //		Gisselquist Technology, LLC
 //
@@ -39,14 +42,32 @@
 #ifndef	MICNCO_H
 #define	MICNCO_H
 
+#include <stdio.h>
+#include "stimulus.h"
+
 class MICNCO {
-	unsigned	m_phase, m_step, m_dstep, m_ticks, m_state;
-	int		m_last_sck, m_oreg;
+	unsigned	m_ticks, m_state;
+	int		m_last_sck, m_oreg, m_last_oreg;
+	CHIRP		m_chirp;
+	STIMULUS	*m_stim;
 public:
-	bool		m_bomb;
-	MICNCO();
+	bool		m_bomb, m_debug;
+	// With debug, reports the chirp's rates, and every new A/D word
+	MICNCO(bool debug = false);
 	void	step(unsigned s);
+	// Replaces the input signal.  The caller keeps ownership of s.  NULL
+	// returns to the default chirp.
+	void	stimulus(STIMULUS *s);
 	int operator()(int sck, int csn);
+	// The next A/D word, as it would be shifted out over the SPI port.
+	// Used to give samples straight to a design built with ADC_BYPASS.
+	int	adc_word(void);
+	// ... given the stimulus's sample
+	static	int	adc_word(int sample);
+
+	// Checkpoint support
+	void	save(FILE *fp) const;
+	bool	restore(FILE *fp);
 };
 
 #endif
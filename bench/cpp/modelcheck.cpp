@@ -0,0 +1,234 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/modelcheck.cpp
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Checks the bit exact models (SUBFILDOWN, WINDOWFN, FFTMAIN,
+//		and logfn) against themselves: a fixed input goes through
+//	both designs' chains of them, and a hash of each stage's output is
+//	printed for every FFT frame.  "make check" builds this twice, with and
+//	without any vector instructions, and compares both against the
+//	committed modelcheck.ref, so that neither a change to a model nor a
+//	SIMD path that disagrees with the portable one goes unnoticed.  No
+//	Verilator is required.
+//
+//	modelcheck.ref was itself written by these models, so none of this
+//	says whether they match the RTL.  That's for the scoreboard (-C) of
+//	main_headless and ddr_headless, which make check-rtl runs.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include "subfildown.h"
+#include "windowfn.h"
+#include "fftmain.h"
+#include "logfn.h"
+
+// A/D samples fed to each design's models: enough for a dozen or so FFT
+// frames through the (slower) filter of hdmiddr.v
+static	const	unsigned long	NSAMPLES = 800000;
+
+// HASH
+// {{{
+// A 64-bit FNV-1a hash of everything a model produced over one FFT frame
+class	HASH {
+	uint64_t	m_h;
+	unsigned long	m_n;
+public:
+	HASH(void) { reset(); }
+	void	reset(void) { m_h = 0xcbf29ce484222325ull; m_n = 0; }
+	void	add(unsigned v) {
+		for(int k=0; k<4; k++) {
+			m_h ^= (v >> (8*k)) & 0x0ff;
+			m_h *= 0x100000001b3ull;
+		}
+		m_n++;
+	}
+	void	print(FILE *fp, const char *name) const {
+		fprintf(fp, " %s %5lu:%016lx", name, m_n,
+			(unsigned long)m_h);
+	}
+};
+// }}}
+
+// sample()
+// {{{
+// The k'th A/D sample: a triangle wave, sweeping up from DC, plus a little
+// noise.  Integers only, so the samples (and so the reference results) are
+// the same no matter which math library or processor made them.
+static	int	sample(unsigned long k, uint32_t &seed) {
+	uint32_t	phase, t;
+	int		v;
+
+	// The phase advances by (k/8) / 2^32 cycles per sample
+	phase = (uint32_t)((k * (k+1) / 16) & 0xffffffff);
+	t = phase >> 19;			// 13 bits
+	v = (int)((t < 0x1000) ? t : 0x1fff - t) - 2048;
+	v = v * 3 / 4;
+
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	v += (int)(seed & 0x1ff) - 256;
+
+	if (v < -2048)
+		v = -2048;
+	else if (v > 2047)
+		v = 2047;
+	return v;
+}
+// }}}
+
+// check()
+// {{{
+// Runs NSAMPLES through the filter, window, FFT, and log stages of one
+// design, printing one line per FFT frame with a hash of what each stage
+// produced during that frame.  lsb is the first bit of the filter's output
+// the window is fed from.
+static	bool	check(const char *name, SUBFILDOWN &fil, const char *coeffs,
+			int lsb) {
+	WINDOWFN	wndw;
+	FFTMAIN		fft;
+	HASH		hfil, hwin, hfft, hlog;
+	uint32_t	seed = 0x2545f491;
+	unsigned long	frames = 0;
+
+	if (!fil.ok() || !fil.load(coeffs) || !wndw.load("hanning.hex")
+			|| !fft.load())
+		return false;
+
+	for(unsigned long k=0; k<NSAMPLES; k++) {
+		int	r, out[2], n;
+
+		if (!fil(sample(k, seed), r))
+			continue;
+		hfil.add(r);
+
+		n = wndw(r >> lsb, out);
+		for(int j=0; j<n; j++) {
+			const unsigned	*f;
+
+			hwin.add(out[j]);
+			f = fft((out[j] & 0x0fff) << 12);
+			if (!f)
+				continue;
+
+			for(int b=0; b<FFTMAIN::SIZE; b++) {
+				hfft.add(f[b]);
+				hlog.add(logfn((int16_t)(f[b] >> 16),
+						(int16_t)f[b]));
+			}
+
+			printf("%-7s %3lu:", name, frames++);
+			hfil.print(stdout, "fil");
+			hwin.print(stdout, "win");
+			hfft.print(stdout, "fft");
+			hlog.print(stdout, "log");
+			printf("\n");
+			hfil.reset(); hwin.reset(); hfft.reset(); hlog.reset();
+		}
+	}
+
+	return true;
+}
+// }}}
+
+// worstcase()
+// {{{
+// Every product at its largest: full scale (negative) samples against full
+// scale (negative) coefficients.  This is where a vector path summing too
+// many products into a 32-bit lane would overflow.
+static	void	worstcase(const char *name, SUBFILDOWN &fil, int ncoeffs) {
+	int	*coeffs = new int[ncoeffs];
+	HASH	hfil;
+	int	r, last = 0;
+
+	for(int k=0; k<ncoeffs; k++)
+		coeffs[k] = -2048;
+	fil.load(coeffs);
+	delete[] coeffs;
+
+	for(int k=0; k<4*ncoeffs; k++)
+		if (fil(-2048, r)) {
+			hfil.add(r);
+			last = r;
+		}
+
+	printf("%-7s max:", name);
+	hfil.print(stdout, "fil");
+	printf(" last %d\n", last);
+}
+// }}}
+
+static	void	usage(void) {
+	// {{{
+	fprintf(stderr,
+"USAGE: modelcheck [-h]\n"
+"\n"
+"\tRuns a fixed A/D input through the bit exact models of the filter,\n"
+"\twindow, FFT, and log stages of both main.v and hdmiddr.v, and prints\n"
+"\ta hash of what each stage produced during every FFT frame.  \"make\n"
+"\tcheck\" compares this against modelcheck.ref, as written by these\n"
+"\tsame models, to catch any change in them.  It doesn't check them\n"
+"\tagainst the RTL: make check-rtl does that.  The coefficient and\n"
+"\ttwiddle files (make hexf) must be in the current directory.\n");
+}
+// }}}
+
+int	main(int argc, char **argv) {
+	// {{{
+	SUBFILDOWN	mainfil(12, 20, 12, 23, 1023, 2),
+			ddrfil(12, 21, 12, 125, 4095, 0);
+	int		opt;
+
+	while((opt = getopt(argc, argv, "h")) != -1) {
+		switch(opt) {
+		case 'h': usage(); exit(EXIT_SUCCESS); break;
+		default:
+			usage();
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	// hdmiddr feeds the window from fil_sample[14:3], main.v from [11:0]
+	if (!check("main", mainfil, "subfildown.hex", 0)
+		|| !check("hdmiddr", ddrfil, "subfildownlow.hex", 3))
+		exit(EXIT_FAILURE);
+
+	worstcase("main", mainfil, 1023);
+	worstcase("hdmiddr", ddrfil, 4095);
+	exit(EXIT_SUCCESS);
+}
+// }}}
@@ -0,0 +1,218 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/probes.cpp
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	The probe registry and logic analyzer described in probes.h.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "probes.h"
+
+PROBES::PROBES(void) {
+	// {{{
+	m_nprobes = 0;
+	m_clock   = -1;
+	m_changes = false;
+	m_mask  = 0;
+	m_count = 0;
+	m_when = m_data = m_last = NULL;
+}
+// }}}
+
+PROBES::~PROBES(void) {
+	disarm();
+}
+
+int	PROBES::add(const char *name, const void *ptr, unsigned bytes,
+		unsigned bits) {
+	// {{{
+	PROBE	*p;
+
+	if (m_nprobes >= MAX_PROBES || m_data) {
+		fprintf(stderr, "ERR: Cannot add probe %s\n", name);
+		return -1;
+	}
+
+	p = &m_probe[m_nprobes];
+	strncpy(p->m_name, name, sizeof(p->m_name)-1);
+	p->m_name[sizeof(p->m_name)-1] = '\0';
+	p->m_ptr   = ptr;
+	p->m_bytes = bytes;
+	p->m_bits  = bits;
+
+	return m_nprobes++;
+}
+// }}}
+
+int	PROBES::find(const char *name) const {
+	// {{{
+	for(int k=0; k<m_nprobes; k++)
+		if (strcmp(m_probe[k].m_name, name) == 0)
+			return k;
+	return -1;
+}
+// }}}
+
+const unsigned char *PROBES::signal(const char *name) const {
+	// {{{
+	int	k = find(name);
+
+	if (k < 0 || m_probe[k].m_bytes != 1)
+		return NULL;
+	return (const unsigned char *)m_probe[k].m_ptr;
+}
+// }}}
+
+bool	PROBES::arm(int clock, unsigned long depth, bool changes) {
+	// {{{
+	unsigned long	ln = 1;
+
+	disarm();
+	if (m_nprobes == 0 || depth == 0)
+		return false;
+
+	while(ln < depth)
+		ln <<= 1;
+
+	m_mask  = ln-1;
+	m_count = 0;
+	m_changes = changes;
+	m_when = new uint64_t[ln];
+	m_data = new uint64_t[ln * m_nprobes];
+	m_last = new uint64_t[m_nprobes]();
+	m_clock = clock;
+
+	return true;
+}
+// }}}
+
+void	PROBES::disarm(void) {
+	// {{{
+	m_clock = -1;
+	delete[] m_when;
+	delete[] m_data;
+	delete[] m_last;
+	m_when = m_data = m_last = NULL;
+	m_mask = m_count = 0;
+}
+// }}}
+
+void	PROBES::write_csv(FILE *fp) const {
+	// {{{
+	unsigned long	n = held();
+
+	fprintf(fp, "clock");
+	for(int k=0; k<m_nprobes; k++)
+		fprintf(fp, ",%s", m_probe[k].m_name);
+	fprintf(fp, "\n");
+
+	for(unsigned long i = m_count - n; i<m_count; i++) {
+		const uint64_t	*row = &m_data[(i & m_mask) * m_nprobes];
+
+		fprintf(fp, "%lu", (unsigned long)m_when[i & m_mask]);
+		for(int k=0; k<m_nprobes; k++) {
+			if (m_probe[k].m_bits > 1)
+				fprintf(fp, ",0x%0*lx",
+					(int)(m_probe[k].m_bits+3)/4,
+					(unsigned long)row[k]);
+			else
+				fprintf(fp, ",%lu", (unsigned long)row[k]);
+		}
+		fprintf(fp, "\n");
+	}
+}
+// }}}
+
+bool	PROBES::write_bin(FILE *fp) const {
+	// {{{
+	uint32_t	np = m_nprobes;
+	uint64_t	n = held();
+	bool		r = true;
+
+	if (fwrite(PROBES_MAGIC, strlen(PROBES_MAGIC), 1, fp) != 1
+			|| fwrite(&np, sizeof(np), 1, fp) != 1)
+		return false;
+
+	for(int k=0; k<m_nprobes; k++) {
+		PROBEREC	rec;
+
+		memset(&rec, 0, sizeof(rec));
+		strcpy(rec.m_name, m_probe[k].m_name);
+		rec.m_bits = m_probe[k].m_bits;
+		if (fwrite(&rec, sizeof(rec), 1, fp) != 1)
+			return false;
+	}
+
+	if (fwrite(&n, sizeof(n), 1, fp) != 1)
+		return false;
+	for(unsigned long i = m_count - n; i<m_count && r; i++) {
+		r = r && (fwrite(&m_when[i & m_mask], sizeof(uint64_t), 1, fp) == 1);
+		r = r && (fwrite(&m_data[(i & m_mask) * m_nprobes],
+				sizeof(uint64_t), m_nprobes, fp)
+					== (size_t)m_nprobes);
+	}
+
+	return r;
+}
+// }}}
+
+bool	PROBES::dump(const char *fname) const {
+	// {{{
+	FILE		*fp;
+	const char	*ext = strrchr(fname, '.');
+	bool		csv = (ext && strcmp(ext, ".csv") == 0), r = true;
+
+	fp = fopen(fname, (csv) ? "w" : "wb");
+	if (!fp) {
+		fprintf(stderr, "ERR: Could not open %s for writing\n", fname);
+		perror("O/S Err:");
+		return false;
+	}
+
+	if (csv)
+		write_csv(fp);
+	else
+		r = write_bin(fp);
+
+	if (ferror(fp))
+		r = false;
+	fclose(fp);
+
+	if (!r)
+		fprintf(stderr, "ERR: Could not write probes to %s\n", fname);
+	return r;
+}
+// }}}
@@ -0,0 +1,171 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/probes.h
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	A registry of signals within the design, reached by name, together
+//		with a small logic analyzer.  Once armed, the analyzer samples
+//	every registered signal on every tick of a chosen clock into a ring
+//	buffer of fixed size, so that it may be left running for long runs
+//	at little cost.  The last samples taken may then be written out as
+//	CSV, or in a binary format, at any time.
+//
+//	Test benches register their signals by their address within the
+//	Verilated model.  Those internal to the design need to be public
+//	(see main.v), and are found using the VVAR() macro, which covers the
+//	differences in naming between Verilator versions.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#ifndef	PROBES_H
+#define	PROBES_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+// The binary dump format.  After the magic string comes a uint32_t count of
+// probes, and then a PROBEREC for each.  The samples follow: a uint64_t
+// count of them, then for each sample the uint64_t clock tick it was taken
+// on and a uint64_t value for each probe, oldest sample first.
+#define	PROBES_MAGIC	"PROBES1\n"
+
+typedef	struct	PROBEREC_S {
+	char		m_name[32];
+	uint32_t	m_bits;
+} PROBEREC;
+
+class	PROBES {
+public:
+	static	const	int	MAX_PROBES = 32;
+
+	typedef	struct	PROBE_S {
+		char		m_name[32];
+		const void	*m_ptr;
+		unsigned	m_bytes, m_bits;
+	} PROBE;
+
+	PROBE		m_probe[MAX_PROBES];
+	int		m_nprobes;
+
+	// The logic analyzer.  m_clock is the clock to sample on, or -1
+	// when not sampling at all.
+	int		m_clock;
+	bool		m_changes;	// Keep only samples that differ
+	unsigned long	m_mask, m_count;
+	uint64_t	*m_when, *m_data, *m_last;
+
+	PROBES(void);
+	~PROBES(void);
+
+	// add()
+	// {{{
+	// Registers a signal by name.  The signal must remain where it is
+	// for as long as it is probed.  Returns the index of the probe, or
+	// -1 if there's no more room.
+	int	add(const char *name, const void *ptr, unsigned bytes,
+			unsigned bits);
+	int	add(const char *name, const uint8_t *ptr, unsigned bits = 1) {
+		return add(name, ptr, 1, bits);
+	}
+	int	add(const char *name, const uint16_t *ptr, unsigned bits=16) {
+		return add(name, ptr, 2, bits);
+	}
+	int	add(const char *name, const uint32_t *ptr, unsigned bits=32) {
+		return add(name, ptr, 4, bits);
+	}
+	int	add(const char *name, const uint64_t *ptr, unsigned bits=64) {
+		return add(name, ptr, 8, bits);
+	}
+	// }}}
+
+	// Returns the index of the named probe, or -1 if there's none
+	int	find(const char *name) const;
+
+	// Returns a single byte (i.e. CData) signal by name, or NULL
+	const unsigned char	*signal(const char *name) const;
+
+	uint64_t	value(int k) const {
+		const PROBE	*p = &m_probe[k];
+
+		switch(p->m_bytes) {
+		case 1:	return *(const uint8_t  *)p->m_ptr;
+		case 2:	return *(const uint16_t *)p->m_ptr;
+		case 4:	return *(const uint32_t *)p->m_ptr;
+		default: return *(const uint64_t *)p->m_ptr;
+		}
+	}
+
+	// Starts sampling every probe on every tick of the given clock,
+	// keeping the last depth samples (rounded up to a power of two).
+	// Any probes must be added first.
+	bool	arm(int clock, unsigned long depth, bool changes = false);
+	void	disarm(void);
+
+	// sample()
+	// {{{
+	// Called by the test bench on every tick of m_clock
+	void	sample(uint64_t when) {
+		uint64_t	*row;
+		bool		same = (m_count > 0);
+
+		for(int k=0; k<m_nprobes; k++) {
+			uint64_t	v = value(k);
+
+			if (v != m_last[k]) {
+				m_last[k] = v;
+				same = false;
+			}
+		}
+
+		if (m_changes && same)
+			return;
+
+		row = &m_data[(m_count & m_mask) * m_nprobes];
+		for(int k=0; k<m_nprobes; k++)
+			row[k] = m_last[k];
+		m_when[m_count & m_mask] = when;
+		m_count++;
+	}
+	// }}}
+
+	// The number of samples held
+	unsigned long	held(void) const {
+		return (m_count > m_mask) ? m_mask+1 : m_count;
+	}
+
+	// Writes every sample held to fname, as CSV if fname ends in
+	// .csv, in binary (see above) otherwise
+	bool	dump(const char *fname) const;
+	void	write_csv(FILE *fp) const;
+	bool	write_bin(FILE *fp) const;
+};
+
+#endif
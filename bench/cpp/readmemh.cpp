@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/readmemh.cpp
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Reads a Verilog hex memory file.  See readmemh.h.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+#include "readmemh.h"
+
+int	readmemh(const char *fname, uint64_t *mem, int n) {
+	// {{{
+	FILE	*fp;
+	char	word[64];
+	int	addr = 0, nread = 0, ch;
+
+	if (!(fp = fopen(fname, "r"))) {
+		fprintf(stderr, "ERR: Cannot open %s\n", fname);
+		return -1;
+	}
+
+	while((ch = fgetc(fp)) != EOF) {
+		unsigned	ln = 0;
+
+		if (isspace(ch))
+			continue;
+		if (ch == '/') {
+			// Comments, either // to the end of the line, or /* */
+			ch = fgetc(fp);
+			if (ch == '/') {
+				while((ch = fgetc(fp)) != EOF && ch != '\n')
+					;
+			} else if (ch == '*') {
+				int	last = 0;
+
+				while((ch = fgetc(fp)) != EOF
+						&& !(last == '*' && ch == '/'))
+					last = ch;
+			}
+			continue;
+		}
+
+		// Collect the rest of the word
+		word[ln++] = ch;
+		while((ch = fgetc(fp)) != EOF && !isspace(ch)) {
+			if (ln < sizeof(word)-1)
+				word[ln++] = ch;
+		}
+		word[ln] = '\0';
+
+		if (word[0] == '@')
+			addr = (int)strtoul(&word[1], NULL, 16);
+		else if (addr < n) {
+			mem[addr++] = strtoull(word, NULL, 16);
+			nread++;
+		}
+	}
+
+	fclose(fp);
+	return nread;
+}
+// }}}
+
+int	readmemh(const char *fname, unsigned *mem, int n) {
+	// {{{
+	uint64_t	*wide = new uint64_t[n];
+	int		nread;
+
+	for(int k=0; k<n; k++)
+		wide[k] = mem[k];
+	nread = readmemh(fname, wide, n);
+	for(int k=0; k<n; k++)
+		mem[k] = (unsigned)wide[k];
+
+	delete[] wide;
+	return nread;
+}
+// }}}
@@ -0,0 +1,58 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/readmemh.h
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Reads the hex files used to initialize the design's memories
+//		(filter taps, windows and FFT twiddles), so that the C++ models
+//	of those parts of the design may use the same values.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#ifndef	READMEMH_H
+#define	READMEMH_H
+
+#include <stdint.h>
+
+// Reads up to n words from the hex file fname into mem, as Verilog's
+// $readmemh would, returning the number of words read, or -1 if the file
+// can't be read at all.  Words that aren't given are left as they were.
+// Use the 64-bit version for memories wider than 32 bits, such as the
+// FFT's twiddle factors.
+extern	int	readmemh(const char *fname, unsigned *mem, int n);
+extern	int	readmemh(const char *fname, uint64_t *mem, int n);
+
+// Sign extends the low w bits of v
+static inline	int	sbits(unsigned v, int w) {
+	return (int)(v << (32-w)) >> (32-w);
+}
+
+#endif
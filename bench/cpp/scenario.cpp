@@ -0,0 +1,261 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/scenario.cpp
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Reads, and keeps track of, the settings for a headless run of
+//		either test bench.  See scenario.h.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+
+#include "scenario.h"
+
+// The colormaps, in the order rtl/colormap.v selects them
+static	const	char	*CMAP_NAMES[] = { "bw", "mid", "mmr", "lin", "gt" };
+static	const	int	NCMAPS = sizeof(CMAP_NAMES)/sizeof(CMAP_NAMES[0]);
+
+SCENARIO::SCENARIO(void) {
+	// {{{
+	m_frames   = 180;
+	m_colormap = 4;
+	m_psnr     = 0;
+	m_scoreboard = false;
+	m_stim = m_outdir = m_golden = m_hashes = NULL;
+	m_stream = m_shm = m_trace = m_window = NULL;
+	m_probes = m_restore = m_save = NULL;
+
+	m_latency = 27;
+	m_ddr3    = false;
+	m_memlog  = m_stats = NULL;
+}
+// }}}
+
+SCENARIO::~SCENARIO(void) {
+	// {{{
+	free(m_stim);    free(m_outdir); free(m_golden); free(m_hashes);
+	free(m_trace);   free(m_window); free(m_probes); free(m_stream);
+	free(m_restore); free(m_save);   free(m_shm);
+	free(m_memlog);  free(m_stats);
+}
+// }}}
+
+static	void	setstr(char *&str, const char *value) {
+	// {{{
+	free(str);
+	str = (value && *value) ? strdup(value) : NULL;
+}
+// }}}
+
+static	bool	getnum(const char *value, unsigned long &v) {
+	// {{{
+	char	*end;
+
+	v = strtoul(value, &end, 0);
+	return (end != value && *end == '\0');
+}
+// }}}
+
+int	SCENARIO::colormap(const char *name) {
+	// {{{
+	unsigned long	v;
+
+	for(int k=0; k<NCMAPS; k++)
+		if (strcmp(name, CMAP_NAMES[k]) == 0)
+			return k;
+	if (getnum(name, v) && v < (unsigned long)NCMAPS)
+		return (int)v;
+	return -1;
+}
+// }}}
+
+const char *SCENARIO::colormap_name(int cmap) {
+	// {{{
+	return (cmap >= 0 && cmap < NCMAPS) ? CMAP_NAMES[cmap] : "?";
+}
+// }}}
+
+bool	SCENARIO::set(const char *key, const char *value) {
+	// {{{
+	unsigned long	v;
+	bool		ok = true;
+
+	if (strcmp(key, "frames") == 0)
+		ok = getnum(value, m_frames);
+	else if (strcmp(key, "colormap") == 0) {
+		int	c = colormap(value);
+
+		ok = (c >= 0);
+		if (ok)
+			m_colormap = c;
+	} else if (strcmp(key, "stimulus") == 0)
+		setstr(m_stim, value);
+	else if (strcmp(key, "outdir") == 0)
+		setstr(m_outdir, value);
+	else if (strcmp(key, "golden") == 0)
+		setstr(m_golden, value);
+	else if (strcmp(key, "psnr") == 0) {
+		char	*end;
+
+		m_psnr = strtod(value, &end);
+		ok = (end != value && *end == '\0' && m_psnr >= 0);
+	} else if (strcmp(key, "scoreboard") == 0) {
+		ok = getnum(value, v);
+		if (ok)
+			m_scoreboard = (v != 0);
+	} else if (strcmp(key, "hashes") == 0)
+		setstr(m_hashes, value);
+	else if (strcmp(key, "stream") == 0)
+		setstr(m_stream, value);
+	else if (strcmp(key, "shm") == 0) {
+		// POSIX shared memory names must start with a '/', and may be
+		// no longer than NAME_MAX
+		char	name[NAME_MAX+1];
+
+		if (value && value[0] && value[0] != '/') {
+			ok = snprintf(name, sizeof(name), "/%s", value)
+						< (int)sizeof(name);
+			if (ok)
+				setstr(m_shm, name);
+		} else
+			setstr(m_shm, value);
+	} else if (strcmp(key, "trace") == 0)
+		setstr(m_trace, value);
+	else if (strcmp(key, "window") == 0)
+		setstr(m_window, value);
+	else if (strcmp(key, "probes") == 0)
+		setstr(m_probes, value);
+	else if (strcmp(key, "restore") == 0)
+		setstr(m_restore, value);
+	else if (strcmp(key, "save") == 0)
+		setstr(m_save, value);
+	else if (strcmp(key, "latency") == 0) {
+		ok = getnum(value, v) && v > 0;
+		if (ok)
+			m_latency = (unsigned)v;
+	} else if (strcmp(key, "ddr3") == 0) {
+		ok = getnum(value, v);
+		if (ok)
+			m_ddr3 = (v != 0);
+	} else if (strcmp(key, "memlog") == 0)
+		setstr(m_memlog, value);
+	else if (strcmp(key, "stats") == 0)
+		setstr(m_stats, value);
+	else {
+		fprintf(stderr, "ERR: Unknown scenario setting, %s\n", key);
+		return false;
+	}
+
+	if (!ok)
+		fprintf(stderr, "ERR: Bad value for %s, %s\n", key, value);
+	return ok;
+}
+// }}}
+
+bool	SCENARIO::load(const char *fname) {
+	// {{{
+	FILE	*fp;
+	char	line[512];
+	int	lineno = 0;
+	bool	ok = true;
+
+	fp = fopen(fname, "r");
+	if (!fp) {
+		fprintf(stderr, "ERR: Cannot open scenario file %s\n", fname);
+		perror("O/S Err:");
+		return false;
+	}
+
+	while(ok && fgets(line, sizeof(line), fp)) {
+		char	*key, *value, *end;
+
+		lineno++;
+		if ((end = strchr(line, '#')) != NULL)
+			*end = '\0';
+
+		// Trim any white space from either end
+		key = line;
+		while(isspace(*key))
+			key++;
+		end = key + strlen(key);
+		while(end > key && isspace(end[-1]))
+			*--end = '\0';
+		if (*key == '\0')
+			continue;
+
+		// The key ends at the first space or '='
+		value = key;
+		while(*value && !isspace(*value) && *value != '=')
+			value++;
+		if (*value)
+			*value++ = '\0';
+		while(isspace(*value) || *value == '=')
+			value++;
+
+		ok = set(key, value);
+		if (!ok)
+			fprintf(stderr, "ERR: ... on line %d of %s\n", lineno, fname);
+	}
+
+	fclose(fp);
+	return ok;
+}
+// }}}
+
+void	SCENARIO::dump(FILE *fp) const {
+	// {{{
+	const char	*names[] = { "stimulus", "outdir", "golden", "hashes",
+				"stream", "shm", "trace", "window", "probes",
+				"restore", "save", "memlog", "stats" };
+	const char	*values[] = { m_stim, m_outdir, m_golden, m_hashes,
+				m_stream, m_shm, m_trace, m_window, m_probes,
+				m_restore, m_save, m_memlog, m_stats };
+
+	fprintf(fp, "frames\t\t%lu\n", m_frames);
+	fprintf(fp, "colormap\t%s\n", colormap_name(m_colormap));
+	if (m_psnr > 0)
+		fprintf(fp, "psnr\t\t%g\n", m_psnr);
+	if (m_scoreboard)
+		fprintf(fp, "scoreboard\t1\n");
+	fprintf(fp, "latency\t\t%u\n", m_latency);
+	fprintf(fp, "ddr3\t\t%d\n", (m_ddr3) ? 1:0);
+	for(unsigned k=0; k<sizeof(names)/sizeof(names[0]); k++)
+		if (values[k])
+			fprintf(fp, "%s%s%s\n", names[k],
+				(strlen(names[k]) < 8) ? "\t\t" : "\t",
+				values[k]);
+}
+// }}}
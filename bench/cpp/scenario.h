@@ -0,0 +1,106 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/scenario.h
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	A scenario: the frame count, stimulus, trace window, output
+//		directories, memory latency and colormap for a headless run of
+//	either test bench, read from the command line, a scenario file, or both.
+//
+//	A scenario file might read,
+//
+//		# Twenty frames of a chirp in noise, checked against a
+//		# prior run
+//		frames		20
+//		stimulus	chirp+noise:0.01
+//		colormap	gt
+//		golden		golden/
+//		latency		40
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#ifndef	SCENARIO_H
+#define	SCENARIO_H
+
+#include <stdio.h>
+
+// SCENARIO
+// {{{
+// Everything about a headless run that might otherwise be given on the
+// command line, so that the same run may be described once in a file and
+// repeated.  Command line options and scenario files both end up calling
+// set(), so whichever comes last wins.
+class	SCENARIO {
+public:
+	unsigned long	m_frames;	// Stop after this many frames
+	int		m_colormap;	// 0-4, see rtl/colormap.v
+	double		m_psnr;		// Golden frames may be this close
+	bool		m_scoreboard;	// Check each stage against the models
+	char		*m_stim,	// Stimulus spec, see stimulus.h
+			*m_outdir,	// Write every frame here
+			*m_golden,	// Compare every frame to those here
+			*m_hashes,	// Log the hash of every frame here
+			*m_stream,	// Stream every frame here
+			*m_shm,		// Publish every frame to this shm ring
+			*m_trace,	// Trace into this file
+			*m_window,	// ... but only over this window
+			*m_probes,	// Probe signals into this file
+			*m_restore,	// Start from this snapshot
+			*m_save;	// Write a snapshot here when done
+
+	// These only apply to the DDR3 SDRAM design (ddr_tb.cpp)
+	unsigned	m_latency;	// Memory latency, in clocks
+	bool		m_ddr3;		// Model the SDRAM's timing
+	char		*m_memlog,	// Log memory requests here
+			*m_stats;	// Write bus statistics here
+
+	SCENARIO(void);
+	~SCENARIO(void);
+
+	// Sets one setting, by name, as it would be given in a scenario file.
+	// Returns false (after complaining) if the name or value make no
+	// sense.
+	bool	set(const char *key, const char *value);
+
+	// Reads a scenario file, one "key value" (or "key = value") per line.
+	// Blank lines, and anything following a '#', are ignored.
+	bool	load(const char *fname);
+
+	// Converts a colormap name (bw, mid, mmr, lin, or gt), or number, to
+	// the number the design expects on i_cmap.  Returns -1 if unknown.
+	static	int	colormap(const char *name);
+	static	const char	*colormap_name(int cmap);
+
+	// Lists every setting, in a form load() can read back
+	void	dump(FILE *fp) const;
+};
+// }}}
+#endif
@@ -0,0 +1,299 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/scoreboard.cpp
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Checks the design against the bit exact C++ models while the
+//		simulation runs.  See scoreboard.h.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "logfn.h"
+#include "scoreboard.h"
+
+static	void	init_check(SBCHECK &ck, const char *name, unsigned lgdepth,
+			unsigned bits, unsigned lgframe) {
+	// {{{
+	ck.m_name    = name;
+	ck.m_fifo    = new unsigned[1u << lgdepth];
+	ck.m_mask    = (1u << lgdepth)-1;
+	ck.m_vmask   = (bits >= 32) ? ~0u : ((1u << bits)-1);
+	ck.m_lgframe = lgframe;
+	ck.m_head = ck.m_tail = ck.m_errors = 0;
+	ck.m_synced  = false;
+}
+// }}}
+
+SCOREBOARD::SCOREBOARD(void) {
+	// {{{
+	m_ring = new SBEVENT[1ul << LGRING];
+	m_head = m_tail = m_tail_seen = m_stalls = 0;
+	m_quit = false;
+	m_probes  = NULL;
+	m_fil     = NULL;
+	m_lsb     = 0;
+	m_running = false;
+
+	// Filter outputs are counted in frames of half an FFT, the distance
+	// between one FFT frame and the next.
+	init_check(m_ckfil, "FIL",  6, 32, FFTMAIN::LGSIZE-1);
+	init_check(m_ckpre, "PRE",  6, FFTMAIN::IWIDTH, FFTMAIN::LGSIZE);
+	init_check(m_ckfft, "FFT", FFTMAIN::LGSIZE+2, 2*FFTMAIN::OWIDTH,
+						FFTMAIN::LGSIZE);
+	init_check(m_cklog, "LOG", FFTMAIN::LGSIZE+2, 8, FFTMAIN::LGSIZE);
+}
+// }}}
+
+SCOREBOARD::~SCOREBOARD(void) {
+	// {{{
+	finish();
+	delete[] m_ring;
+	delete[] m_ckfil.m_fifo;
+	delete[] m_ckpre.m_fifo;
+	delete[] m_ckfft.m_fifo;
+	delete[] m_cklog.m_fifo;
+	delete m_fil;
+}
+// }}}
+
+bool	SCOREBOARD::start(const PROBES &probes, SUBFILDOWN *fil, int lsb) {
+	// {{{
+	const char	*names[] = { "adc_ce", "adc_sample", "fil_ce",
+				"fil_sample", "pre_ce", "pre_sample",
+				"fft_sample", "fft_sync", "raw_pixel",
+				"raw_sync" };
+	int		*index[] = { &m_adc_ce, &m_adc_sample, &m_fil_ce,
+				&m_fil_sample, &m_pre_ce, &m_pre_sample,
+				&m_fft_sample, &m_fft_sync, &m_raw_pixel,
+				&m_raw_sync };
+
+	delete m_fil;
+	m_fil = fil;
+	m_lsb = lsb;
+	if (!m_fil || !m_fil->ok())
+		return false;
+
+	for(unsigned k=0; k<sizeof(names)/sizeof(names[0]); k++) {
+		if ((*index[k] = probes.find(names[k])) < 0) {
+			fprintf(stderr, "ERR: The scoreboard needs the %s probe\n",
+				names[k]);
+			return false;
+		}
+	}
+	m_probes = &probes;
+
+	if (!m_win.load("hanning.hex") || !m_fft.load())
+		return false;
+	m_ckfil.m_vmask = (1u << m_fil->ow())-1;
+
+	m_quit = false;
+	if (pthread_create(&m_thread, NULL, worker, this) != 0) {
+		perror("O/S Err:");
+		return false;
+	}
+	m_running = true;
+	return true;
+}
+// }}}
+
+void	SCOREBOARD::finish(void) {
+	// {{{
+	if (!m_running)
+		return;
+
+	__atomic_store_n(&m_quit, true, __ATOMIC_RELEASE);
+	pthread_join(m_thread, NULL);
+	m_running = false;
+}
+// }}}
+
+void	*SCOREBOARD::worker(void *arg) {
+	// {{{
+	((SCOREBOARD *)arg)->run();
+	return NULL;
+}
+// }}}
+
+void	SCOREBOARD::run(void) {
+	// {{{
+	const	struct timespec	nap = { 0, 50000 };
+	unsigned long	tail = m_tail, head;
+
+	while(1) {
+		// Read m_quit first, so that once it's set, any events pushed
+		// before it are sure to be seen below
+		bool	quit = __atomic_load_n(&m_quit, __ATOMIC_ACQUIRE);
+
+		head = __atomic_load_n(&m_head, __ATOMIC_ACQUIRE);
+		if (head == tail) {
+			if (quit)
+				break;
+			nanosleep(&nap, NULL);
+			continue;
+		}
+
+		for(; tail != head; tail++) {
+			process(m_ring[tail & ((1ul<<LGRING)-1)]);
+
+			// Hand the slots back every so often, rather than
+			// bouncing m_tail's cache line for every event
+			if ((tail & 0x0ff) == 0)
+				__atomic_store_n(&m_tail, tail+1,
+							__ATOMIC_RELEASE);
+		}
+		__atomic_store_n(&m_tail, tail, __ATOMIC_RELEASE);
+	}
+}
+// }}}
+
+void	SCOREBOARD::expect(SBCHECK &ck, unsigned v) {
+	// {{{
+	if (ck.m_head - ck.m_tail > ck.m_mask) {
+		// The RTL has fallen a long way behind the model.  Make room,
+		// and count what's lost as a failure.
+		if (ck.m_errors++ < MAX_REPORTS)
+			printf("SCOREBOARD: %s stage has produced nothing for %u samples\n",
+				ck.m_name, ck.m_mask+1);
+		ck.m_tail++;
+	}
+
+	ck.m_fifo[(ck.m_head++) & ck.m_mask] = v & ck.m_vmask;
+}
+// }}}
+
+void	SCOREBOARD::check(SBCHECK &ck, unsigned v, bool sync) {
+	// {{{
+	unsigned long	n = ck.m_tail;
+	unsigned	frame_mask = (1u << ck.m_lgframe)-1;
+
+	v &= ck.m_vmask;
+	if (ck.m_tail == ck.m_head) {
+		if (ck.m_errors++ < MAX_REPORTS)
+			printf("SCOREBOARD: %s frame %lu, bin %u: RTL produced %x, model produced nothing\n",
+				ck.m_name, n >> ck.m_lgframe,
+				(unsigned)(n & frame_mask), v);
+		return;
+	}
+
+	unsigned	want = ck.m_fifo[(ck.m_tail++) & ck.m_mask];
+	bool		first = ((n & frame_mask) == 0);
+
+	if (v != want || sync != first) {
+		if (ck.m_errors++ < MAX_REPORTS)
+			printf("SCOREBOARD: %s frame %lu, bin %u: RTL %x%s, model %x%s\n",
+				ck.m_name, n >> ck.m_lgframe,
+				(unsigned)(n & frame_mask),
+				v, (sync) ? " (sync)" : "",
+				want, (first) ? " (sync)" : "");
+	}
+}
+// }}}
+
+void	SCOREBOARD::process(const SBEVENT &ev) {
+	// {{{
+	int	wout[2];
+
+	switch(ev.m_kind) {
+	case SB_ADC: {
+		int	r;
+
+		if ((*m_fil)(ev.m_value, r))
+			expect(m_ckfil, r);
+		} break;
+	case SB_FIL:
+		// Filter outputs have no sync of their own, so call the first
+		// of every frame synchronized
+		check(m_ckfil, ev.m_value,
+			(m_ckfil.m_tail & ((1u<<m_ckfil.m_lgframe)-1)) == 0);
+		for(int k=0, n=m_win(ev.m_value >> m_lsb, wout); k<n; k++)
+			expect(m_ckpre, wout[k]);
+		break;
+	case SB_PRE: {
+		const unsigned	*frame;
+		bool		fft_sync = (ev.m_sync & 1) != 0,
+				raw_sync = (ev.m_sync & 2) != 0;
+
+		// The window
+		check(m_ckpre, ev.m_value,
+			(m_ckpre.m_tail & ((1u<<m_ckpre.m_lgframe)-1)) == 0);
+
+		// The FFT, which starts on the first pre_ce following a reset
+		frame = m_fft((ev.m_value & 0x0fff) << 12);
+		if (frame) {
+			for(int k=0; k<FFTMAIN::SIZE; k++)
+				expect(m_ckfft, frame[k]);
+		}
+
+		// The FFT's outputs, and logfn's, mean nothing until the first
+		// sync
+		m_ckfft.m_synced = m_ckfft.m_synced || fft_sync;
+		if (m_ckfft.m_synced) {
+			check(m_ckfft, ev.m_fft, fft_sync);
+			expect(m_cklog, logfn((int16_t)(ev.m_fft >> 16),
+						(int16_t)ev.m_fft));
+		}
+
+		m_cklog.m_synced = m_cklog.m_synced || raw_sync;
+		if (m_cklog.m_synced)
+			check(m_cklog, ev.m_pixel, raw_sync);
+		} break;
+	default:
+		break;
+	}
+}
+// }}}
+
+bool	SCOREBOARD::report(FILE *fp) {
+	// {{{
+	const SBCHECK	*ck[] = { &m_ckfil, &m_ckpre, &m_ckfft, &m_cklog };
+	bool		pass = true;
+
+	finish();
+	for(unsigned k=0; k<sizeof(ck)/sizeof(ck[0]); k++) {
+		if (fp)
+			fprintf(fp, "SCOREBOARD: %s %9lu checked, %lu failed\n",
+				ck[k]->m_name, ck[k]->m_tail,
+				ck[k]->m_errors);
+		if (ck[k]->m_errors > 0)
+			pass = false;
+	}
+
+	if (fp && m_stalls > 0)
+		fprintf(fp, "SCOREBOARD: The simulation waited on the checker %lu times\n",
+			m_stalls);
+	return pass;
+}
+// }}}
@@ -0,0 +1,206 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/scoreboard.h
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Checks the design against the bit exact C++ models, stage by
+//		stage, while the simulation runs.
+//
+//	On every clock, the simulation thread looks (through PROBES) for
+//	samples into the subband filter (adc_ce), out of it (fil_ce), and
+//	out of the window (pre_ce).  Any it finds are copied into a lock-free
+//	ring, and a checker thread takes them from there.  The simulation
+//	thread never waits on the checker unless the ring fills.
+//
+//	Each stage is checked against its model fed with the RTL's own input
+//	to that stage: the filter with the A/D's samples, the window with
+//	fil_sample, the FFT with pre_sample, and logfn with fft_sample.  A
+//	mistake in one stage is thus reported against that stage alone, by
+//	frame and bin, rather than in every stage that follows.
+//
+//	This only works for the Hanning window.  Designs built with the hires
+//	window (HIRESOLUTION) will fail the window's check.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#ifndef	SCOREBOARD_H
+#define	SCOREBOARD_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "probes.h"
+#include "subfildown.h"
+#include "windowfn.h"
+#include "fftmain.h"
+
+// SBEVENT
+// {{{
+// One event, as captured by the simulation thread.  On an A/D or filter
+// sample, only m_value means anything.  On a pre_ce, m_value is the window's
+// output (pre_sample), and the rest are the FFT's output and logfn's output
+// (fft_sample and raw_pixel) together with their syncs.
+typedef	struct	SBEVENT_S {
+	uint32_t	m_value, m_fft;
+	uint8_t		m_kind, m_pixel, m_sync;
+} SBEVENT;
+// }}}
+
+// SBCHECK
+// {{{
+// One stage of the pipeline being checked: a FIFO of the values the model
+// says the RTL should produce next, and how the RTL has done against them
+typedef	struct	SBCHECK_S {
+	const char	*m_name;
+	unsigned	*m_fifo, m_mask,	// Values the RTL should produce
+			m_vmask,		// The bits that matter
+			m_lgframe;		// log_2 of values per frame
+	unsigned long	m_head, m_tail,		// Pushed, and checked
+			m_errors;
+	bool		m_synced;	// Set once the first sync is seen
+} SBCHECK;
+// }}}
+
+class	SCOREBOARD {
+public:
+	static	const	unsigned	LGRING = 16,	// Events in flight
+					MAX_REPORTS = 8; // Per stage
+private:
+	// The event ring.  The simulation thread alone writes m_head and the
+	// ring, the checker alone writes m_tail.  Each keeps to its own cache
+	// line, and the simulation thread only looks at m_tail once the ring
+	// appears to be full.
+	// {{{
+	SBEVENT		*m_ring;
+	unsigned long	m_head __attribute__((aligned(64))),
+			m_tail_seen, m_stalls;
+	unsigned long	m_tail __attribute__((aligned(64)));
+	bool		m_quit;
+	// }}}
+
+	// Where to find each signal within PROBES
+	int		m_adc_ce, m_adc_sample, m_fil_ce, m_fil_sample,
+			m_pre_ce, m_pre_sample, m_fft_sample, m_fft_sync,
+			m_raw_pixel, m_raw_sync;
+	const PROBES	*m_probes;
+
+	// The reference models, and the checks against each
+	SUBFILDOWN	*m_fil;
+	WINDOWFN	m_win;
+	FFTMAIN		m_fft;
+	int		m_lsb;		// First bit of fil_sample windowed
+	SBCHECK		m_ckfil, m_ckpre, m_ckfft, m_cklog;
+	bool		m_running;
+	pthread_t	m_thread;
+
+	static	void	*worker(void *arg);
+	void	run(void);
+	void	process(const SBEVENT &ev);
+	void	expect(SBCHECK &ck, unsigned v);
+	void	check(SBCHECK &ck, unsigned v, bool sync);
+
+	// push()
+	// {{{
+	void	push(unsigned kind, uint32_t value, uint32_t fft = 0,
+			unsigned pixel = 0, unsigned sync = 0) {
+		SBEVENT	*ev;
+
+		if (m_head - m_tail_seen > (1ul<<LGRING)-1) {
+			m_tail_seen = __atomic_load_n(&m_tail, __ATOMIC_ACQUIRE);
+			while(m_head - m_tail_seen > (1ul<<LGRING)-1) {
+				// The checker has fallen behind, wait on it
+				m_stalls++;
+				sched_yield();
+				m_tail_seen = __atomic_load_n(&m_tail,
+							__ATOMIC_ACQUIRE);
+			}
+		}
+
+		ev = &m_ring[m_head & ((1ul<<LGRING)-1)];
+		ev->m_value = value;
+		ev->m_fft   = fft;
+		ev->m_kind  = kind;
+		ev->m_pixel = pixel;
+		ev->m_sync  = sync;
+		__atomic_store_n(&m_head, m_head+1, __ATOMIC_RELEASE);
+	}
+	// }}}
+public:
+	enum	{ SB_ADC, SB_FIL, SB_PRE };
+
+	SCOREBOARD(void);
+	~SCOREBOARD(void);
+
+	// start()
+	// {{{
+	// Finds adc_ce, adc_sample, fil_ce, fil_sample, pre_ce, pre_sample,
+	// fft_sample, fft_sync, raw_pixel, and raw_sync among the probes,
+	// loads the window (hanning.hex) and FFT (cmem_*.hex) models, and
+	// starts checking in a thread of its own.  fil must be a SUBFILDOWN
+	// configured, and loaded, just like the design's, and lsb the first
+	// bit of fil_sample the design feeds to its window.  The scoreboard
+	// takes ownership of fil.  Checking must start from reset.
+	bool	start(const PROBES &probes, SUBFILDOWN *fil, int lsb);
+	// }}}
+
+	// True once started, even after finish()
+	bool	active(void) const { return m_probes != NULL; }
+
+	// sample()
+	// {{{
+	// Called from the simulation thread, on every clock, before any
+	// inputs are changed.  Anything the design is about to act upon is
+	// passed on to the checker.
+	void	sample(void) {
+		const PROBES	&p = *m_probes;
+
+		if (p.value(m_adc_ce))
+			push(SB_ADC, p.value(m_adc_sample));
+		if (p.value(m_fil_ce))
+			push(SB_FIL, p.value(m_fil_sample));
+		if (p.value(m_pre_ce))
+			push(SB_PRE, p.value(m_pre_sample),
+				p.value(m_fft_sample), p.value(m_raw_pixel),
+				(p.value(m_fft_sync) ? 1:0)
+				| (p.value(m_raw_sync) ? 2:0));
+	}
+	// }}}
+
+	// Waits for the checker to catch up, and stops it
+	void	finish(void);
+
+	// Reports on each stage to fp, returning true if nothing failed
+	bool	report(FILE *fp = stdout);
+};
+
+#endif
@@ -0,0 +1,229 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/shmframes.cpp
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Publishes decoded frames into, and reads them back out of, a
+//		ring of frames in POSIX shared memory.  See shmframes.h.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "shmframes.h"
+
+static	const	unsigned long	PAGESZ = 4096;
+
+bool	SHMFRAMES::create(const char *name, int w, int h, int nslots) {
+	// {{{
+	int		fd;
+	unsigned long	offset;
+
+	close();
+
+	if (nslots < 2)
+		nslots = 2;
+	else if (nslots > SHMFRAMES_MAXSLOTS)
+		nslots = SHMFRAMES_MAXSLOTS;
+	offset = (sizeof(SHMFRAMES_HEADER) + PAGESZ-1) & ~(PAGESZ-1);
+	m_size = offset + (unsigned long)nslots * w * h * sizeof(uint32_t);
+
+	// Start over, rather than confuse any viewer still attached to an
+	// older ring of a different size
+	shm_unlink(name);
+	fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644);
+	if (fd < 0 || ftruncate(fd, m_size) != 0) {
+		fprintf(stderr, "ERR: Cannot create shared memory %s\n", name);
+		perror("O/S Err:");
+		if (fd >= 0) {
+			::close(fd);
+			shm_unlink(name);
+		}
+		return false;
+	}
+
+	m_hdr = (SHMFRAMES_HEADER *)mmap(NULL, m_size, PROT_READ | PROT_WRITE,
+				MAP_SHARED, fd, 0);
+	::close(fd);
+	if (m_hdr == MAP_FAILED) {
+		perror("O/S Err:");
+		m_hdr = NULL;
+		shm_unlink(name);
+		return false;
+	}
+
+	// ftruncate() has already zeroed everything, including m_seq
+	m_hdr->m_version = SHMFRAMES_VERSION;
+	m_hdr->m_width   = w;
+	m_hdr->m_height  = h;
+	m_hdr->m_nslots  = nslots;
+	m_hdr->m_offset  = offset;
+	m_frames = (uint32_t *)((char *)m_hdr + offset);
+	m_name   = strdup(name);
+	m_owner  = true;
+
+	// Only now is the header complete
+	__atomic_store_n(&m_hdr->m_magic, SHMFRAMES_MAGIC, __ATOMIC_RELEASE);
+	return true;
+}
+// }}}
+
+void	SHMFRAMES::publish(const unsigned *pixels) {
+	// {{{
+	uint64_t	seq;
+	unsigned	slot, n;
+
+	if (!m_hdr || !m_owner)
+		return;
+
+	seq  = m_hdr->m_seq;
+	slot = seq % m_hdr->m_nslots;
+	n    = m_hdr->m_width * m_hdr->m_height;
+
+	// Odd: being written
+	__atomic_add_fetch(&m_hdr->m_lock[slot], 1, __ATOMIC_ACQ_REL);
+	memcpy(&m_frames[(unsigned long)slot * n], pixels, n*sizeof(uint32_t));
+	// Even: done
+	__atomic_add_fetch(&m_hdr->m_lock[slot], 1, __ATOMIC_RELEASE);
+
+	__atomic_store_n(&m_hdr->m_seq, seq+1, __ATOMIC_RELEASE);
+}
+// }}}
+
+bool	SHMFRAMES::attach(const char *name) {
+	// {{{
+	int		fd;
+	struct stat	sb;
+
+	close();
+
+	fd = shm_open(name, O_RDONLY, 0);
+	if (fd < 0) {
+		fprintf(stderr, "ERR: Cannot open shared memory %s\n", name);
+		perror("O/S Err:");
+		return false;
+	}
+
+	if (fstat(fd, &sb) != 0 || (unsigned long)sb.st_size
+				< sizeof(SHMFRAMES_HEADER)) {
+		fprintf(stderr, "ERR: %s is not (yet) a frame ring\n", name);
+		::close(fd);
+		return false;
+	}
+
+	m_size = sb.st_size;
+	m_hdr  = (SHMFRAMES_HEADER *)mmap(NULL, m_size, PROT_READ, MAP_SHARED,
+				fd, 0);
+	::close(fd);
+	if (m_hdr == MAP_FAILED) {
+		perror("O/S Err:");
+		m_hdr = NULL;
+		return false;
+	}
+
+	if (__atomic_load_n(&m_hdr->m_magic, __ATOMIC_ACQUIRE)
+				!= SHMFRAMES_MAGIC
+			|| m_hdr->m_version != SHMFRAMES_VERSION
+			|| m_hdr->m_nslots > SHMFRAMES_MAXSLOTS
+			|| m_hdr->m_offset + (unsigned long)m_hdr->m_nslots
+				* m_hdr->m_width * m_hdr->m_height
+				* sizeof(uint32_t) > m_size) {
+		fprintf(stderr, "ERR: %s is not a (compatible) frame ring\n",
+			name);
+		munmap(m_hdr, m_size);
+		m_hdr = NULL;
+		return false;
+	}
+
+	m_frames = (uint32_t *)((char *)m_hdr + m_hdr->m_offset);
+	m_name   = strdup(name);
+	m_owner  = false;
+	return true;
+}
+// }}}
+
+bool	SHMFRAMES::latest(unsigned *dst, uint64_t &seq) const {
+	// {{{
+	unsigned	n;
+
+	if (!m_hdr)
+		return false;
+
+	n = m_hdr->m_width * m_hdr->m_height;
+	for(int tries=0; tries < 8; tries++) {
+		uint64_t	s, before, after;
+		unsigned	slot;
+
+		s = __atomic_load_n(&m_hdr->m_seq, __ATOMIC_ACQUIRE);
+		if (s == 0 || s == seq)
+			return false;
+		slot = (s-1) % m_hdr->m_nslots;
+
+		before = __atomic_load_n(&m_hdr->m_lock[slot], __ATOMIC_ACQUIRE);
+		if (before & 1)
+			continue;
+		memcpy(dst, &m_frames[(unsigned long)slot * n],
+				n*sizeof(uint32_t));
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		after = __atomic_load_n(&m_hdr->m_lock[slot], __ATOMIC_RELAXED);
+
+		if (before == after) {
+			seq = s;
+			return true;
+		}
+	}
+
+	// The writer kept lapping us.  Try again later.
+	return false;
+}
+// }}}
+
+void	SHMFRAMES::close(void) {
+	// {{{
+	if (m_hdr) {
+		munmap(m_hdr, m_size);
+		if (m_owner)
+			shm_unlink(m_name);
+	}
+
+	free(m_name);
+	m_hdr    = NULL;
+	m_frames = NULL;
+	m_name   = NULL;
+	m_owner  = false;
+}
+// }}}
@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/shmframes.h
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Publishes decoded frames into a ring of frames in POSIX shared
+//		memory, so that a viewer in another process (shmview) may display
+//	them at its own pace.  The simulation never waits on the viewer, and
+//	a viewer may come and go while a long headless run continues.
+//
+//	Each slot of the ring is guarded by a sequence lock: the writer makes
+//	the slot's count odd before writing it, and even again after.  A
+//	reader copies the slot out, and then checks that the count was even
+//	and unchanged throughout.  If not, the writer has lapped it, and it
+//	tries again with the newest frame.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#ifndef	SHMFRAMES_H
+#define	SHMFRAMES_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#define	SHMFRAMES_MAGIC		0x4d484646	// "FFHM"
+#define	SHMFRAMES_VERSION	1
+#define	SHMFRAMES_MAXSLOTS	16
+
+// SHMFRAMES_HEADER
+// {{{
+// The start of the shared memory region.  The frames follow, each
+// m_width * m_height 0x00RRGGBB pixels, beginning on the next page.
+typedef	struct	SHMFRAMES_HEADER_S {
+	uint32_t	m_magic, m_version,
+			m_width, m_height, m_nslots, m_offset;
+	// The number of frames published so far.  The last one is in slot
+	// (m_seq-1) % m_nslots.
+	uint64_t	m_seq;
+	// One sequence lock per slot: odd while the slot is being written
+	uint64_t	m_lock[SHMFRAMES_MAXSLOTS];
+} SHMFRAMES_HEADER;
+// }}}
+
+// SHMFRAMES
+// {{{
+// Either end of the ring: the simulation, which creates it and publishes
+// frames into it, or a viewer, which attaches to it (read only) and copies
+// frames out.  Neither ever waits on the other.
+class	SHMFRAMES {
+public:
+	SHMFRAMES_HEADER	*m_hdr;
+	uint32_t		*m_frames;
+	unsigned long		m_size;
+	char			*m_name;
+	bool			m_owner;
+
+	SHMFRAMES(void) : m_hdr(NULL), m_frames(NULL), m_size(0),
+			m_name(NULL), m_owner(false) {}
+	~SHMFRAMES(void) { close(); }
+
+	// Creates (or replaces) the ring called name, of nslots frames, each
+	// w x h.  The name is a POSIX shared memory name, such as /fftdemo.
+	bool	create(const char *name, int w, int h, int nslots = 4);
+
+	// Copies a frame into the next slot of the ring
+	void	publish(const unsigned *pixels);
+
+	// Maps an existing ring, read only
+	bool	attach(const char *name);
+
+	// Copies the most recent frame into dst, if it is newer than seq,
+	// updating seq.  Returns false if there's nothing new.
+	bool	latest(unsigned *dst, uint64_t &seq) const;
+
+	int	width(void) const  { return (m_hdr) ? m_hdr->m_width : 0; }
+	int	height(void) const { return (m_hdr) ? m_hdr->m_height : 0; }
+	bool	isopen(void) const { return m_hdr != NULL; }
+
+	// Unmaps the ring, removing it as well if we created it
+	void	close(void);
+};
+// }}}
+#endif
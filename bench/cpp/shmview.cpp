@@ -0,0 +1,245 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/shmview.cpp
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	A viewer for the frames a test bench publishes into shared memory
+//		(see shmframes.h), running as a process of its own.  Start a long
+//	headless run with, for example,
+//
+//		./ddr_headless -n 100000 -S /fftdemo
+//
+//	and then attach to it, and detach from it, as often as desired with
+//
+//		./shmview /fftdemo
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifndef	HEADLESS
+#include <gtkmm.h>
+#endif
+
+#include "shmframes.h"
+
+#define	PROGNAME	"shmview"
+
+void	usage(void) {
+	// {{{
+	fprintf(stderr,
+"USAGE: " PROGNAME " [-h] [-o <file>] [<name>]\n"
+"\n"
+"\tDisplays the frames a test bench, run with -S <name>, publishes into\n"
+"\tshared memory, at whatever pace the display can manage.  The viewer\n"
+"\tmay be started before the test bench, and will follow it if it is\n"
+"\trestarted.  <name> defaults to /fftdemo.\n"
+"\n"
+"\t-h\tDisplays this usage statement\n"
+"\t-o <file>\tWrites the next frame published to <file>, as a (P6)\n"
+"\t\tPPM file, rather than opening a window\n");
+}
+// }}}
+
+// grab()
+// {{{
+// Waits for the next frame from the ring, and writes it to a PPM file
+static	bool	grab(SHMFRAMES &ring, const char *fname) {
+	unsigned	*frame;
+	unsigned char	*line;
+	uint64_t	seq = ring.m_hdr->m_seq;
+	FILE		*fp;
+	int		w = ring.width(), h = ring.height();
+
+	frame = new unsigned[w*h];
+	while(!ring.latest(frame, seq))
+		usleep(10000);
+
+	if (!(fp = fopen(fname, "wb"))) {
+		fprintf(stderr, "ERR: Could not open %s for writing\n", fname);
+		perror("O/S Err:");
+		delete[] frame;
+		return false;
+	}
+
+	fprintf(fp, "P6\n%d %d\n255\n", w, h);
+	line = new unsigned char[3*w];
+	for(int y=0; y<h; y++) {
+		for(int x=0; x<w; x++) {
+			unsigned	p = frame[y*w+x];
+
+			line[3*x  ] = (p >> 16) & 0x0ff;
+			line[3*x+1] = (p >>  8) & 0x0ff;
+			line[3*x+2] = (p      ) & 0x0ff;
+		}
+		fwrite(line, 3, w, fp);
+	}
+
+	fclose(fp);
+	delete[] line;
+	delete[] frame;
+	return true;
+}
+// }}}
+
+#ifndef	HEADLESS
+// SHMVIEW
+// {{{
+// A window onto the ring, checking it for a new frame sixty times a second
+class	SHMVIEW : public Gtk::DrawingArea {
+public:
+	typedef	const Cairo::RefPtr<Cairo::Context>	CONTEXT;
+	typedef	Cairo::RefPtr<Cairo::ImageSurface>	CAIROIMG;
+
+	const char	*m_name;
+	SHMFRAMES	m_ring;
+	CAIROIMG	m_pix;
+	unsigned	*m_frame;
+	uint64_t	m_seq;
+	int		m_idle;	// Checks since the last new frame
+
+	SHMVIEW(const char *name) : m_name(name), m_frame(NULL), m_seq(0),
+			m_idle(0) {
+		set_size_request(640, 480);
+		Glib::signal_timeout().connect(sigc::mem_fun((*this),
+				&SHMVIEW::on_timeout), 1000/60);
+	}
+
+	~SHMVIEW(void) { delete[] m_frame; }
+
+	// (Re)attaches to the ring, resizing to match it
+	bool	reattach(void) {
+		SHMFRAMES	ring;
+
+		if (!ring.attach(m_name))
+			return false;
+		if (m_ring.isopen() && ring.m_hdr->m_seq == m_ring.m_hdr->m_seq)
+			// Still the same ring, or near enough
+			return true;
+
+		m_ring.close();
+		if (!m_ring.attach(m_name))
+			return false;
+		m_seq = 0;
+
+		delete[] m_frame;
+		m_frame = new unsigned[m_ring.width() * m_ring.height()];
+		m_pix = Cairo::ImageSurface::create(Cairo::FORMAT_RGB24,
+				m_ring.width(), m_ring.height());
+		set_size_request(m_ring.width(), m_ring.height());
+		return true;
+	}
+
+	bool	on_timeout(void) {
+		unsigned char	*dp;
+		int		w, h;
+
+		if (!m_ring.isopen() || !m_ring.latest(m_frame, m_seq)) {
+			// Once a second, see whether the test bench has
+			// (re)started, and made a new ring
+			if (++m_idle >= 60) {
+				m_idle = 0;
+				reattach();
+			}
+			return true;
+		}
+		m_idle = 0;
+
+		// RGB24 surfaces are 0x00RRGGBB, as are the frames
+		w  = m_ring.width();
+		h  = m_ring.height();
+		dp = m_pix->get_data();
+		m_pix->flush();
+		for(int y=0; y<h; y++)
+			memcpy(dp + y * m_pix->get_stride(), &m_frame[y*w],
+				w * sizeof(unsigned));
+		m_pix->mark_dirty();
+		queue_draw();
+		return true;
+	}
+
+	bool	on_draw(CONTEXT &gc) {
+		if (!m_pix)
+			return true;
+		gc->save();
+		gc->set_source(m_pix, 0, 0);
+		gc->paint();
+		gc->restore();
+		return true;
+	}
+};
+// }}}
+#endif
+
+int	main(int argc, char **argv) {
+	const char	*name = "/fftdemo", *ppm = NULL;
+	int		opt;
+
+	while((opt = getopt(argc, argv, "ho:")) != -1) {
+		switch(opt) {
+		case 'h': usage(); exit(EXIT_SUCCESS); break;
+		case 'o': ppm = optarg; break;
+		default:
+			usage();
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (optind < argc)
+		name = argv[optind];
+
+	if (ppm) {
+		SHMFRAMES	ring;
+
+		if (!ring.attach(name) || !grab(ring, ppm))
+			exit(EXIT_FAILURE);
+		exit(EXIT_SUCCESS);
+	}
+
+#ifdef	HEADLESS
+	fprintf(stderr, "ERR: Built without a GUI, so only -o is supported\n");
+	exit(EXIT_FAILURE);
+#else
+	Gtk::Main	main_instance(argc, argv);
+	Gtk::Window	win;
+	SHMVIEW		view(name);
+
+	view.reattach();
+	win.set_title(Glib::ustring("FFT-DEMO: ") + name);
+	win.add(view);
+	win.show_all();
+	Gtk::Main::run(win);
+	exit(EXIT_SUCCESS);
+#endif
+}
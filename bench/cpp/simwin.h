@@ -38,10 +38,29 @@
 #ifndef	SIMWIN_H
 #define	SIMWIN_H
 
+#include <string.h>
 #include <gtkmm.h>
 #include "image.h"
 #include "videomode.h"
 
+// copy_line()
+// {{{
+// Copies pixels [x0,x1) of line y of a decoded image into a surface, for
+// VGASIM and HDMISIM alike.  The RGB24 surface format uses one native 32-bit
+// word per pixel, 0x00RRGGBB--the same format as the image.  Hence we can
+// copy the changed pixels straight into the surface, so long as Cairo has
+// finished with it first, and tell Cairo about it after.
+static inline void	copy_line(const Cairo::RefPtr<Cairo::ImageSurface> &pix,
+			const unsigned *src, int y, int x0, int x1) {
+	unsigned	*sp;
+
+	pix->flush();
+	sp = (unsigned *)(pix->get_data() + y * pix->get_stride());
+	memcpy(&sp[x0], &src[x0], (x1-x0)*sizeof(unsigned));
+	pix->mark_dirty(x0, y, x1-x0, 1);
+}
+// }}}
+
 class	SIMWIN	: public Gtk::Window {
 protected:
 	VIDEOMODE	m_vmode;
@@ -0,0 +1,376 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/specgram.cpp
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Renders the spectrogram of an audio file, of any length, just as
+//		the design (hdmiddr.v) would draw it, but all at once rather
+//	than scrolling by at 15 or so columns a second.  The work is split
+//	into chunks of columns, each on a thread of its own.  Every chunk runs
+//	its own copy of the bit exact models from reset, starting a few
+//	columns early, so the image is the same no matter how it's split.
+//
+//		./specgram -o out.ppm -c mmr recording.wav
+//
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "micnco.h"
+#include "subfildown.h"
+#include "windowfn.h"
+#include "fftmain.h"
+#include "logfn.h"
+#include "colormap.h"
+#include "specmodel.h"
+#include "scenario.h"
+#include "threadpool.h"
+
+// The design only displays the first HEIGHT bins of each FFT, the first at
+// the bottom of the screen
+static	const	int	HEIGHT = 600;
+// Columns run before the first one kept by each job, to fill the filter and
+// the window.  The A/D samples these span must reach back further than the
+// filter's and the window's memories put together.
+static	const	unsigned long	WARMUP = 3;
+
+// RENDER
+// {{{
+// What every job needs to know, and where they all put their results
+typedef	struct	RENDER_S {
+	const char	*m_fname;
+	double		m_rate;
+	unsigned long	m_ncols,	// Columns in all
+			m_chunk;	// ... and per job
+	unsigned long	m_colsamples;	// A/D samples per column
+	unsigned char	*m_cols;	// logfn's output, FFTMAIN::SIZE/column
+	bool		m_failed;
+} RENDER;
+// }}}
+
+// PIPELINE
+// {{{
+// The signal processing half of rtl/hdmiddr.v, from reset, as
+// SCOREBOARD and SPECMODEL have it
+class	PIPELINE {
+	SUBFILDOWN	*m_fil;
+	WINDOWFN	m_wndw;
+	FFTMAIN		m_fft;
+public:
+	PIPELINE(void) : m_fil(NULL) {}
+	~PIPELINE(void) { delete m_fil; }
+	bool	load(void) {
+		delete m_fil;
+		m_fil = SPECMODEL::filter();
+		return m_fil && m_wndw.load("hanning.hex") && m_fft.load();
+	}
+
+	// Takes one A/D sample, and returns a column (the FFT's output) any
+	// time this completes one
+	const unsigned	*operator()(int s) {
+		const unsigned	*fr = NULL;
+		int		r, out[2], n;
+
+		if (!(*m_fil)(MICNCO::adc_word(s), r))
+			return NULL;
+
+		n = m_wndw(SPECMODEL::window_input(r), out);
+		for(int k=0; k<n; k++) {
+			const unsigned	*f = m_fft((out[k] & 0x0fff) << 12);
+			if (f)
+				fr = f;
+		}
+		return fr;
+	}
+};
+// }}}
+
+// render()
+// {{{
+// Renders the columns of one job.  Since the filter's decimation, and the
+// window's frames, both repeat every column from reset, a pipeline started
+// from reset on any column boundary produces that column and those following
+// it.  Once WARMUP columns have gone through, they are bit for bit the same
+// columns as those from a pipeline started at the beginning of the file.
+void	render(void *arg, int job) {
+	RENDER		*rnd = (RENDER *)arg;
+	PIPELINE	*pipe;
+	PCMFILE		*pcm;
+	unsigned long	c0, c1, col;
+
+	c0 = job * rnd->m_chunk;
+	c1 = c0 + rnd->m_chunk;
+	if (c1 > rnd->m_ncols)
+		c1 = rnd->m_ncols;
+	col = (c0 > WARMUP) ? c0 - WARMUP : 0;
+
+	pipe = new PIPELINE;
+	pcm  = new PCMFILE(rnd->m_fname, rnd->m_rate, false);
+	if (!pipe->load() || !pcm->ok()) {
+		rnd->m_failed = true;
+		delete pcm;
+		delete pipe;
+		return;
+	}
+
+	pcm->m_pos = col * rnd->m_colsamples * pcm->m_step;
+	while(col < c1) {
+		const unsigned	*fr = (*pipe)(pcm->sample());
+
+		if (!fr)
+			continue;
+		if (col >= c0) {
+			unsigned char	*dst = &rnd->m_cols[col * FFTMAIN::SIZE];
+
+			for(int k=0; k<FFTMAIN::SIZE; k++)
+				dst[k] = logfn((int16_t)(fr[k] >> 16),
+						(int16_t)fr[k]);
+		}
+		col++;
+	}
+
+	delete pcm;
+	delete pipe;
+}
+// }}}
+
+// first_column()
+// {{{
+// Returns the number of A/D samples it takes, from reset, to produce the
+// first column
+unsigned long	first_column(void) {
+	PIPELINE	*pipe = new PIPELINE;
+	unsigned long	n = 0;
+
+	if (!pipe->load()) {
+		delete pipe;
+		return 0;
+	}
+
+	do {
+		n++;
+	} while(!(*pipe)(0));
+
+	delete pipe;
+	return n;
+}
+// }}}
+
+// writeppm()
+// {{{
+// Writes the columns, HEIGHT of each, as a P6 image: time from left to
+// right, frequency from the bottom up, as the design would show them
+bool	writeppm(const char *fname, const RENDER *rnd, int cmap) {
+	FILE		*fp;
+	unsigned char	*line;
+	bool		r = true;
+
+	if (!(fp = fopen(fname, "wb"))) {
+		fprintf(stderr, "ERR: Could not open %s for writing\n", fname);
+		perror("O/S Err:");
+		return false;
+	}
+
+	fprintf(fp, "P6\n%lu %d\n255\n", rnd->m_ncols, HEIGHT);
+	line = new unsigned char[3*rnd->m_ncols];
+	for(int y=0; y<HEIGHT && r; y++) {
+		const unsigned char	*px = &rnd->m_cols[HEIGHT-1-y];
+
+		for(unsigned long x=0; x<rnd->m_ncols; x++) {
+			unsigned	c = colormap(cmap, px[x*FFTMAIN::SIZE]);
+
+			line[3*x  ] = (c >> 16) & 0x0ff;
+			line[3*x+1] = (c >>  8) & 0x0ff;
+			line[3*x+2] = (c      ) & 0x0ff;
+		}
+
+		if (fwrite(line, 3, rnd->m_ncols, fp) != rnd->m_ncols)
+			r = false;
+	}
+
+	delete[] line;
+	if (fclose(fp) != 0)
+		r = false;
+	if (!r)
+		fprintf(stderr, "ERR: Could not write %s\n", fname);
+	return r;
+}
+// }}}
+
+// writeraw()
+// {{{
+// Writes every bin of every column, FFTMAIN::SIZE bytes per column, in order
+bool	writeraw(const char *fname, const RENDER *rnd) {
+	FILE	*fp;
+	bool	r;
+
+	if (!(fp = fopen(fname, "wb"))) {
+		fprintf(stderr, "ERR: Could not open %s for writing\n", fname);
+		perror("O/S Err:");
+		return false;
+	}
+
+	r = fwrite(rnd->m_cols, FFTMAIN::SIZE, rnd->m_ncols, fp)
+			== rnd->m_ncols;
+	if (fclose(fp) != 0)
+		r = false;
+	if (!r)
+		fprintf(stderr, "ERR: Could not write %s\n", fname);
+	return r;
+}
+// }}}
+
+void	usage(void) {
+	// {{{
+	fprintf(stderr,
+"USAGE: specgram [-h] [-c <colormap>] [-j <threads>] [-m <file>] [-n <cols>]\n"
+"\t\t[-o <file>] [-r <rate>] <audio file>\n"
+"\n"
+"\tRenders the spectrogram of a (long) 16-bit PCM or WAV file, exactly\n"
+"\tas the design would draw it, using the bit exact models of its\n"
+"\tfilter, window, FFT, and log stages.  The file is split into chunks\n"
+"\tof columns, rendered on every processor at once.\n"
+"\n"
+"\t-c <colormap>\tColors the image using one of the colormaps bw,\n"
+"\t\tmid, mmr, lin, or gt (default: gt)\n"
+"\t-h\tDisplays this usage statement\n"
+"\t-j <threads>\tRenders on <threads> threads (default: one per\n"
+"\t\tprocessor)\n"
+"\t-m <file>\tWrites every bin of every column, as logfn produces\n"
+"\t\tthem, to <file>: %d bytes per column, the first bin first\n"
+"\t-n <cols>\tRenders <cols> columns per chunk (default: enough for\n"
+"\t\tfour chunks per thread)\n"
+"\t-o <file>\tWrites the image to <file>, as a PPM: one column per\n"
+"\t\tFFT, and the %d bins the design displays, the lowest at the\n"
+"\t\tbottom\n"
+"\t-r <rate>\tThe file's sample rate, in Hz.  The default is that\n"
+"\t\tgiven in a WAV file, or the A/D's %.0f Hz for raw PCM.\n",
+	FFTMAIN::SIZE, HEIGHT, ADC_RATE_HZ);
+}
+// }}}
+
+int	main(int argc, char **argv) {
+	// {{{
+	RENDER		rnd;
+	PCMFILE		*pcm;
+	const char	*ppm = NULL, *raw = NULL;
+	int		opt, cmap = 4, nthreads = nprocessors(), njobs;
+	unsigned long	nadc, first;
+	struct timespec	tstart, tstop;
+	double		elapsed;
+
+	rnd.m_rate  = 0;
+	rnd.m_chunk = 0;
+	rnd.m_failed = false;
+	while((opt = getopt(argc, argv, "c:hj:m:n:o:r:")) != -1) {
+		switch(opt) {
+		case 'c':
+			if ((cmap = SCENARIO::colormap(optarg)) < 0) {
+				fprintf(stderr, "ERR: Unknown colormap, %s\n", optarg);
+				exit(EXIT_FAILURE);
+			} break;
+		case 'h': usage(); exit(EXIT_SUCCESS); break;
+		case 'j': nthreads = atoi(optarg); break;
+		case 'm': raw = optarg; break;
+		case 'n': rnd.m_chunk = strtoul(optarg, NULL, 0); break;
+		case 'o': ppm = optarg; break;
+		case 'r': rnd.m_rate = atof(optarg); break;
+		default:
+			usage();
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (optind != argc-1 || (!ppm && !raw)) {
+		usage();
+		exit(EXIT_FAILURE);
+	} rnd.m_fname = argv[optind];
+	if (nthreads < 1)
+		nthreads = 1;
+
+	// How many A/D samples the file lasts for, and so how many columns
+	// the design would draw before it ran out
+	pcm = new PCMFILE(rnd.m_fname, rnd.m_rate, false);
+	if (!pcm->ok())
+		exit(EXIT_FAILURE);
+	// PCMFILE holds m_nsamples under 2^32, so this can't overflow
+	nadc = (pcm->m_nsamples << 32) / pcm->m_step;
+	if ((pcm->m_nsamples << 32) % pcm->m_step)
+		nadc++;
+	delete pcm;
+
+	if (0 == (first = first_column()))
+		exit(EXIT_FAILURE);
+	{
+		WINDOWFN	wndw;
+
+		// Every other window starts a new FFT
+		rnd.m_colsamples = SPECMODEL::NDOWN * (wndw.size() / 2);
+	}
+	rnd.m_ncols = (nadc >= first)
+			? 1 + (nadc - first) / rnd.m_colsamples : 0;
+	if (rnd.m_ncols == 0) {
+		fprintf(stderr, "ERR: %s is too short for even one column\n",
+			rnd.m_fname);
+		exit(EXIT_FAILURE);
+	}
+
+	if (rnd.m_chunk == 0)
+		rnd.m_chunk = (rnd.m_ncols + 4*nthreads - 1) / (4*nthreads);
+	njobs = (int)((rnd.m_ncols + rnd.m_chunk - 1) / rnd.m_chunk);
+	rnd.m_cols = new unsigned char[rnd.m_ncols * FFTMAIN::SIZE];
+
+	clock_gettime(CLOCK_MONOTONIC, &tstart);
+	run_pool(njobs, nthreads, render, &rnd);
+	clock_gettime(CLOCK_MONOTONIC, &tstop);
+	if (rnd.m_failed)
+		exit(EXIT_FAILURE);
+
+	elapsed = (tstop.tv_sec - tstart.tv_sec)
+			+ (tstop.tv_nsec - tstart.tv_nsec) * 1e-9;
+	printf("%lu columns (%.1f s of audio) in %.3f s, %d chunks on %d threads: %.1fx real time\n",
+		rnd.m_ncols, nadc / ADC_RATE_HZ, elapsed, njobs, nthreads,
+		nadc / ADC_RATE_HZ / elapsed);
+
+	if (ppm && !writeppm(ppm, &rnd, cmap))
+		exit(EXIT_FAILURE);
+	if (raw && !writeraw(raw, &rnd))
+		exit(EXIT_FAILURE);
+
+	delete[] rnd.m_cols;
+	exit(EXIT_SUCCESS);
+}
+// }}}
@@ -0,0 +1,374 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/specmodel.cpp
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	A transaction level model of rtl/hdmiddr.v.  See specmodel.h.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "specmodel.h"
+#include "logfn.h"
+#include "colormap.h"
+
+// hdmiddr.v's last_line_addr, where wrdata writes the bottom of each column
+static	const	unsigned	LAST_LINE_ADDR = SPECMODEL::LINEWORDS
+					* (2*SPECMODEL::HEIGHT-2);
+
+// The clocks as TESTB starts them: i_clk at 100MHz, and the pixel clock at
+// whatever rate ddr_tb then gives it, but starting from the phase
+// TBCLOCK::init(6734) left it in.  Both counted in half periods of ps.
+static	const	unsigned long	CLK_INCREMENT = 5000, PIX_INIT_INCREMENT = 3366;
+
+SPECMODEL::SPECMODEL(bool bypass, unsigned latency) {
+	// {{{
+	unsigned long	pix_increment;
+
+	m_fil     = NULL;
+	m_bypass  = bypass;
+	m_latency = latency;
+	m_adc_clk = (bypass) ? ADC_BYPASS_FIRST : ADC_FIRST;
+	m_npre    = 0;
+	m_npce    = 0;
+	m_cols    = new unsigned char[NCOLS * FFTMAIN::SIZE]();
+	m_ncols   = 0;
+
+	// wrdata, as reset
+	m_offset  = 0;
+	m_next_offset = 1;
+	m_out_offset  = 1;
+	m_addr    = 0;
+	m_lno     = 0;
+	m_height  = HEIGHT;
+	m_lw      = LINEWORDS;
+	m_offscreen = true;
+
+	m_mem     = new uint32_t[1u<<AW]();
+	m_bus_free = 0;
+	m_wr_start = 0;
+	m_wrhead = m_wrtail = 0;
+
+	// As TBCLOCK::set_frequency_hz() would set the pixel clock
+	pix_increment = ((unsigned long)(1e12 / (double)(HRAW * LRAW * 60))
+				>> 1) & -2l;
+	m_pixclk_ps = 2 * pix_increment;
+	m_clk_ps    = 2 * CLK_INCREMENT;
+	// From the first i_clk edge to the first pixel clock edge
+	m_pix0_ps   = (2 * pix_increment - (PIX_INIT_INCREMENT+1))
+			- (CLK_INCREMENT - 1);
+
+	m_nframes = 0;
+	m_clocks  = 0;
+	m_cmap    = 4;
+	m_img     = new unsigned[WIDTH * HEIGHT]();
+}
+// }}}
+
+SPECMODEL::~SPECMODEL(void) {
+	delete m_fil;
+	delete[] m_cols;
+	delete[] m_mem;
+	delete[] m_img;
+}
+
+bool	SPECMODEL::load(void) {
+	delete m_fil;
+	m_fil = filter();
+	return m_fil && m_wndw.load("hanning.hex")
+			&& m_fft.load();
+}
+
+// pixclk()
+// {{{
+// Returns the pixel clock edge on which hdmiframe takes pixel x, of the given
+// line, of the given frame, from its colormap.  genhdmi comes out of reset
+// on the third.
+unsigned long	SPECMODEL::pixclk(unsigned long frame, int line, int x) const {
+	return 3 + frame * (HRAW * LRAW) + line * HRAW + x + 1;
+}
+// }}}
+
+// clk()
+// {{{
+// Returns the first clock (i_clk) edge following a given pixel clock edge
+unsigned long	SPECMODEL::clk(unsigned long pix) const {
+	unsigned long	ps = m_pix0_ps + (pix-1) * m_pixclk_ps;
+
+	return 1 + (ps + m_clk_ps - 1) / m_clk_ps;
+}
+// }}}
+
+// adc()
+// {{{
+// Takes the next A/D sample, and runs it through the filter.  Every NDOWN
+// samples this produces a sample for the window, and so two pre_ce's: one
+// shortly after fil_ce, and one shortly after alt_ce.
+void	SPECMODEL::adc(void) {
+	int	r, out[2];
+
+	if ((*m_fil)(m_mic.adc_word(), r)) {
+		unsigned long	fil_clk = m_adc_clk + FIL_DELAY;
+
+		if (m_wndw(window_input(r), out) == 2) {
+			m_pre_clk[0] = fil_clk + WNDW_DELAY;
+			m_pre_clk[1] = fil_clk + ALT_DELAY + WNDW_DELAY;
+			m_pre_sample[0] = out[0];
+			m_pre_sample[1] = out[1];
+			m_npre = 2;
+		}
+	}
+
+	m_adc_clk += ADC_CLOCKS;
+}
+// }}}
+
+// pre_ce()
+// {{{
+// Gives one sample to the FFT, and steps wrdata, as the design does on each
+// pre_ce.  Once the FFT has a frame, logfn's pixels for it are kept until
+// wrdata gets to them, LOG_DELAY pre_ce's after that frame began.
+void	SPECMODEL::pre_ce(unsigned long clk, int sample) {
+	const unsigned	*fr;
+	unsigned	pixel = 0;
+	bool		sync = false;
+
+	if ((fr = m_fft((sample & 0x0fff) << 12)) != NULL) {
+		unsigned char	*col = &m_cols[(m_ncols % NCOLS)*FFTMAIN::SIZE];
+
+		for(int k=0; k<FFTMAIN::SIZE; k++)
+			col[k] = logfn((int16_t)(fr[k] >> 16), (int16_t)fr[k]);
+		m_ncols++;
+	}
+
+	if (m_npce >= LOG_DELAY) {
+		unsigned long	k = m_npce - LOG_DELAY;
+
+		pixel = m_cols[(k / FFTMAIN::SIZE) % NCOLS * FFTMAIN::SIZE
+				+ (k % FFTMAIN::SIZE)];
+		sync  = (k % FFTMAIN::SIZE) == 0;
+	} m_npce++;
+
+	wrdata(clk, pixel, sync);
+}
+// }}}
+
+// wrdata()
+// {{{
+// A model of rtl/wrdata.v, on one i_ce.  Each column starts at the bottom of
+// memory, one byte to the right of the last, and works its way up two lines
+// (the same pixel, twice) at a time until it is off of the screen.
+void	SPECMODEL::wrdata(unsigned long clk, unsigned pixel, bool sync) {
+	// The bytes written, given the offset's bottom two bits
+	static	const	unsigned	SEL[4] = {
+				0xffffffff, 0x00ffffff, 0x0000ffff, 0x000000ff };
+	WRITE		w;
+	unsigned	o1;
+	bool		wr = (sync) || (!m_offscreen);
+
+	if (sync) {
+		unsigned	nx2 = (m_next_offset >> 2) + 2;
+
+		w.m_addr = (LAST_LINE_ADDR + (m_next_offset >> 2)) & AWMASK;
+		w.m_mask = SEL[m_next_offset & 3];
+		m_lw     = LINEWORDS;
+		m_height = HEIGHT;
+		m_offscreen = false;
+		m_lno    = 0;
+		m_addr   = w.m_addr;
+		m_offset = m_next_offset;
+
+		// The offset hdmiframe will start its next frame from
+		if (((m_next_offset & 3) == 3 && nx2 >= m_lw-1) || nx2 >= m_lw)
+			m_out_offset = 0;
+		else
+			m_out_offset = nx2;
+	} else {
+		w.m_addr = m_addr;
+		w.m_mask = SEL[m_offset & 3];
+		if (!m_offscreen)
+			m_offscreen = (m_lno++ >= m_height-1);
+		m_addr = (m_addr - m_lw - m_lw) & AWMASK;
+	}
+
+	// next_offset follows r_offset, wrapping once the line is full
+	o1 = m_offset + 1;
+	if (((o1 & 3) == 3 && (o1 >> 2) == m_lw-1) || (o1 >> 2) > m_lw-1)
+		m_next_offset = 0;
+	else
+		m_next_offset = o1;
+
+	if (wr) {
+		assert(m_wrtail - m_wrhead <= WRQMASK);
+		w.m_ready = clk + WR_DELAY;
+		w.m_data  = pixel * 0x01010101u;
+		m_wrq[(m_wrtail++) & WRQMASK] = w;
+	}
+}
+// }}}
+
+void	SPECMODEL::write(const WRITE &w) {
+	// {{{
+	uint32_t	*a = &m_mem[w.m_addr],
+			*b = &m_mem[(w.m_addr + m_lw) & AWMASK];
+
+	*a = (*a & ~w.m_mask) | (w.m_data & w.m_mask);
+	*b = (*b & ~w.m_mask) | (w.m_data & w.m_mask);
+}
+// }}}
+
+// advance()
+// {{{
+// Steps the design, one event at a time and in order, up to clock clk.  An
+// event is either an A/D sample, a pre_ce, or a write to memory.  Writes
+// take the bus as soon as it is free, unless a line is being read from it.
+// A write that reached wrdata's FIFO before the one ahead of it got the bus
+// follows that one without letting go of it.
+void	SPECMODEL::advance(unsigned long clk) {
+	for(;;) {
+		unsigned long	next = (m_npre > 0) ? m_pre_clk[2-m_npre]
+					: m_adc_clk;
+
+		if (m_wrhead != m_wrtail) {
+			const WRITE	&w = m_wrq[m_wrhead & WRQMASK];
+			unsigned long	wstart;
+
+			if (w.m_ready <= m_wr_start + WR_DELAY)
+				wstart = m_wr_start + WR_WORDS;
+			else
+				wstart = (w.m_ready > m_bus_free) ? w.m_ready
+					: m_bus_free;
+			if (wstart <= clk && wstart <= next) {
+				write(w);
+				m_wr_start = wstart;
+				m_bus_free = wstart + m_latency + WR_BUSY;
+				m_wrhead++;
+				continue;
+			}
+		}
+
+		if (next > clk)
+			return;
+		else if (m_npre > 0) {
+			int	k = 2 - m_npre;
+
+			m_npre--;
+			pre_ce(m_pre_clk[k], m_pre_sample[k]);
+		} else
+			adc();
+	}
+}
+// }}}
+
+// read()
+// {{{
+// Reads, and colors, one line of LINEWORDS words starting at addr, as soon
+// after clock clk as hdmiframe can get the bus.  wrdata has priority: any
+// write waiting when the bus comes free goes first, and any write coming
+// due while the line is being read waits until it's done.  A write due on
+// the very clock the read is waits too, since hdmiframe will have raised
+// o_wb_cyc, and taken the arbiter, first.  Returns the clock the read
+// started on.
+unsigned long	SPECMODEL::read(unsigned long clk, unsigned addr, unsigned *px) {
+	unsigned long	start;
+
+	do {
+		start = (clk > m_bus_free) ? clk : m_bus_free;
+		advance(start-1);
+	} while(m_bus_free > start);
+
+	// Four pixels per word, the first in the MSB
+	for(int k=0; k<LINEWORDS; k++) {
+		uint32_t	v = m_mem[(addr + k) & AWMASK];
+
+		*px++ = ::colormap(m_cmap, (v >> 24) & 0x0ff);
+		*px++ = ::colormap(m_cmap, (v >> 16) & 0x0ff);
+		*px++ = ::colormap(m_cmap, (v >>  8) & 0x0ff);
+		*px++ = ::colormap(m_cmap,  v        & 0x0ff);
+	}
+
+	m_bus_free = start + m_latency + RD_BUSY;
+	return start;
+}
+// }}}
+
+const unsigned	*SPECMODEL::frame(void) {
+	// {{{
+	unsigned long	frame, nf, when, start = 0;
+	unsigned	base;
+
+	if (m_nframes == 0) {
+		// The decoder has yet to sync, and the design is showing
+		// nothing anyway (genhdmi's first_frame)
+		m_clocks = clk(pixclk(0, HEIGHT, 0));
+		m_nframes++;
+		return m_img;
+	}
+
+	// The first frame displayed is the design's second
+	frame = m_nframes;
+
+	// hdmiframe resets its FIFO on the hdmi_newframe ending the frame
+	// before, which falls as that frame's last pixel is taken.  imgfifo
+	// latches the offset wrdata is giving it on the last clock of its
+	// wb_reset, two clocks after the first one following that.
+	nf = clk(pixclk(frame-1, HEIGHT-1, WIDTH-1));
+	advance(nf+1);
+	base = m_out_offset;
+
+	when = nf + FRAME_DELAY;
+	for(int line=0; line<HEIGHT; line++) {
+		if (line >= FIFO_LINES) {
+			// Once full, the FIFO fetches the next line as soon
+			// as it has room for it.  (o_wfill_level trails the
+			// last word of a line by a clock, which would only
+			// matter were the next line due that soon after.)
+			unsigned long	room;
+
+			room = clk(pixclk(frame, line-FIFO_LINES,
+					REFILL_PIXEL)) + REFILL_DELAY;
+			if (room > when)
+				when = room;
+		}
+
+		start = read(when, base + 2*LINEWORDS*line, &m_img[line*WIDTH]);
+		when = start + m_latency + RD_NEXT;
+	}
+
+	m_clocks = clk(pixclk(frame, HEIGHT, 0));
+	m_nframes++;
+	return m_img;
+}
+// }}}
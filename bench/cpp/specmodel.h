@@ -0,0 +1,240 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/specmodel.h
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	A transaction level model of the whole of rtl/hdmiddr.v: the A/D,
+//		the filter, window, FFT and log stages, wrdata's scrolling
+//	spectrogram in memory, and hdmiframe's reading of that memory and
+//	coloring of every pixel.  Each stage is bit exact (see subfildown.h,
+//	windowfn.h, fftmain.h, logfn.h, and colormap.h), and is stepped only
+//	when it has something to do, so that frames as ddr_tb would decode
+//	them come out several orders of magnitude faster than Verilator
+//	could simulate them.
+//
+//	Where the column being written meets the frame being read depends upon
+//	when each is done.  The model keeps time in clocks, from the design's
+//	latencies, and the bus arbitration between wrdata and hdmiframe.
+//	These are counted from the RTL, as given below, rather than simulated
+//	clock by clock.  make check-ddr holds the two to the same frames,
+//	pixel for pixel.  Should ddr_tb and ddr_model ever disagree, it will
+//	be in the rows where the two cross, and these timing constants are
+//	where to look.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#ifndef	SPECMODEL_H
+#define	SPECMODEL_H
+
+#include <stdint.h>
+#include "micnco.h"
+#include "subfildown.h"
+#include "windowfn.h"
+#include "fftmain.h"
+
+class	SPECMODEL {
+public:
+	// The video mode and memory layout of rtl/hdmiddr.v
+	static	const	int	WIDTH = 800, HEIGHT = 600,
+				HRAW = 1056, LRAW = 628,
+				AW = 19, LINEWORDS = 200;
+
+	// hdmiframe's imgfifo holds 1<<FW (13) words.  It reads another line
+	// whenever it has room for LINEWORDS+2, so it starts each frame by
+	// reading FIFO_LINES of them.  After that, line y is read once the
+	// colormap has taken REFILL_WORDS words from line y-FIFO_LINES.  It
+	// takes the first of those before the line starts, and the next as
+	// each fourth pixel goes, so that's after pixel REFILL_PIXEL.
+	static	const	int	FIFO_WORDS = 1<<13,
+				FIFO_LINES = (FIFO_WORDS-LINEWORDS-2)
+						/ LINEWORDS + 1,
+				REFILL_WORDS = FIFO_LINES * LINEWORDS
+						- (FIFO_WORDS-LINEWORDS-2),
+				REFILL_PIXEL = 4*(REFILL_WORDS-1)-1;
+
+	// The design's timing, in clocks of i_clk, as the test bench drives
+	// it.  Clock one is the (only) clock in reset.  Each time is that of
+	// the clock edge on which a strobe is first seen high, and each is
+	// counted here from the RTL named.
+	static	const	unsigned
+		// hdmiddr's adc_divider counts 0-99, raising adc_start
+		ADC_CLOCKS   = 100,
+		// With ADC_BYPASS, ddr_tb gives the design a sample on every
+		// ADC_CLOCKS'th sim_clk_tick(), the first after reset
+		ADC_BYPASS_FIRST = ADC_CLOCKS + 1,
+		// pmic (CKPCK=3) ignores adc_start on clock one, since its
+		// r_clk has yet to reach CKPCK-1.  It starts on the next, and
+		// after 16 SCK periods of 2*CKPCK clocks raises valid_stb.
+		// r_valid, the design's adc_ce, follows one clock later.
+		PMIC_CKPCK   = 3, PMIC_BITS = 16,
+		ADC_FIRST    = (ADC_CLOCKS + 1) + PMIC_BITS * 2 * PMIC_CKPCK + 1,
+		// subfildown: i_ce, then d_ce, p_ce, and o_ce (fil_ce)
+		FIL_DELAY    = 3,
+		// hdmiddr loads alt_countdown with NDOWN[6:1] on each fil_ce,
+		// and raises alt_ce once it's counted down to one
+		NDOWN        = 125,
+		ALT_DELAY    = NDOWN/2 + 1,
+		// windowfn: i_ce (or i_alt_ce), then d_ce, p_ce, o_ce (pre_ce)
+		WNDW_DELAY   = 3,
+		// wrdata registers fif_ce, its sfifo clears o_empty, and
+		// o_wb_cyc rises.  The first of each pair of words is taken
+		// the clock after.
+		WR_DELAY     = 3,
+		// Each pixel goes to memory twice, one word after the other.
+		WR_WORDS     = 2,
+		// wrdata drops o_wb_cyc on the last ack, and the arbiter only
+		// then gives hdmiframe the bus, a clock later still.  A write
+		// holds the bus this long, plus the latency.
+		WR_BUSY      = WR_WORDS + 1,
+		// imgfifo drops o_wb_cyc on the last ack of a line, and the
+		// arbiter (wrdata's by default) returns to wrdata
+		RD_BUSY      = LINEWORDS + 1,
+		// Between lines read back to back: room_for_another_line is
+		// checked once o_wb_cyc drops, then o_wb_cyc rises, then the
+		// arbiter hands hdmiframe the bus
+		RD_NEXT      = LINEWORDS + 3,
+		// From the first clock after hdmi_newframe falls: three clocks
+		// of wb_reset, then room, o_wb_cyc, and the arbiter
+		FRAME_DELAY  = 6,
+		// From the first clock after the colormap reads the FIFO:
+		// atxfifo's two flop synchronizer, o_wfill_level, then room,
+		// o_wb_cyc, and the arbiter
+		REFILL_DELAY = 6;
+	// The FFT and logfn's latency, in pre_ce's, from the first sample in
+	// to wrdata seeing the first raw_sync.  fftmain's first o_sync comes
+	// 2119 samples in: through its fftstages by the 1084th, qtrstage and
+	// laststage add 6 and 3, bitreverse a frame of 1024, and its own
+	// registers two more.  logfn then takes five.
+	static	const	unsigned long	FFT_DELAY = 2119, LOGFN_DELAY = 5,
+				LOG_DELAY = FFT_DELAY + LOGFN_DELAY;
+
+	// hdmiddr's (low frequency) filter, and the bits of its output,
+	// fil_sample[14:WNDW_LSB], that feed the window.  Everything modeling
+	// this design builds its filter here.
+	static	const	int	WNDW_LSB = 3;
+	static	int	window_input(int fil_sample) {
+		return fil_sample >> WNDW_LSB; }
+	// Returns that filter, loaded with subfildownlow.hex from the current
+	// directory, or NULL should that fail.  The caller owns the result.
+	static	SUBFILDOWN	*filter(void) {
+		SUBFILDOWN	*fil = new SUBFILDOWN(12, 21, 12, NDOWN, 4095, 0);
+
+		if (!fil->ok() || !fil->load("subfildownlow.hex")) {
+			delete fil;
+			return NULL;
+		} return fil;
+	}
+
+	// A pair of writes to memory, one to each copy of a pixel
+	typedef	struct	WRITE_S {
+		unsigned long	m_ready;	// When wrdata can first write
+		unsigned	m_addr, m_data, m_mask;
+	} WRITE;
+private:
+	static	const	unsigned	NCOLS = 4, LGWRQ = 4,
+					WRQMASK = (1u<<LGWRQ)-1,
+					AWMASK = (1u<<AW)-1;
+
+	// The signal processing chain
+	MICNCO		m_mic;
+	SUBFILDOWN	*m_fil;
+	WINDOWFN	m_wndw;
+	FFTMAIN		m_fft;
+	bool		m_bypass;
+	unsigned long	m_adc_clk;	// When the next sample arrives
+	unsigned long	m_pre_clk[2];	// Pending pre_ce's, in order
+	int		m_pre_sample[2], m_npre;
+	unsigned long	m_npce;		// pre_ce's so far
+	unsigned char	*m_cols;	// The last NCOLS columns from logfn
+	unsigned long	m_ncols;
+
+	// wrdata
+	unsigned	m_offset, m_next_offset, m_out_offset, m_addr,
+			m_lno, m_height, m_lw;
+	bool		m_offscreen;
+
+	// The memory, and the bus to it
+	uint32_t	*m_mem;
+	unsigned	m_latency;
+	unsigned long	m_bus_free,	// When the bus may next be used
+			m_wr_start;	// When the last write began
+	WRITE		m_wrq[1<<LGWRQ];
+	unsigned	m_wrhead, m_wrtail;
+
+	// hdmiframe
+	unsigned long	m_pixclk_ps, m_clk_ps,	// Clock periods, in ps
+			m_pix0_ps,	// First pixel clock, after i_clk's
+			m_nframes, m_clocks;
+	int		m_cmap;
+	unsigned	*m_img;
+
+	void	adc(void);
+	void	pre_ce(unsigned long clk, int sample);
+	void	wrdata(unsigned long clk, unsigned pixel, bool sync);
+	void	write(const WRITE &w);
+	unsigned long	read(unsigned long clk, unsigned addr, unsigned *px);
+	unsigned long	pixclk(unsigned long frame, int line, int x) const;
+	unsigned long	clk(unsigned long pixclk) const;
+public:
+	// bypass selects the timing of a design built with ADC_BYPASS
+	// (ddr_bypass), latency the memory's (see ddr_tb -l)
+	SPECMODEL(bool bypass = false, unsigned latency = 27);
+	~SPECMODEL(void);
+
+	// Reads subfildownlow.hex, hanning.hex, and the FFT's cmem_*.hex
+	// files, as the design does, from the current directory
+	bool	load(void);
+
+	// Replaces the microphone's input, as MICNCO::stimulus() does.  The
+	// caller keeps ownership of s.
+	void	stimulus(STIMULUS *s) { m_mic.stimulus(s); }
+
+	// Selects the colormap, as i_cmap would.  May change between frames.
+	void	colormap(int cmap) { m_cmap = cmap; }
+
+	// Advances every part of the design up to the given clock
+	void	advance(unsigned long clk);
+
+	// Returns the next frame, WIDTH x HEIGHT pixels in 0x00RRGGBB form,
+	// just as ddr_tb's video decoder would have it once the design has
+	// sent the same frame.  As with that decoder, the first frame is
+	// blank, the design starts displaying with the second.  The pixels
+	// are good until the next call.
+	const unsigned	*frame(void);
+
+	unsigned long	nframes(void) const { return m_nframes; }
+	// The clock the last frame was finished on
+	unsigned long	clocks(void) const { return m_clocks; }
+	// The number of columns logfn has produced
+	unsigned long	columns(void) const { return m_ncols; }
+};
+
+#endif
@@ -0,0 +1,555 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/stimulus.cpp
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Generates the test signals that may be fed to MICNCO, the
+//		simulated microphone A/D.  See stimulus.h for a list.
+//
+//	All of the tone generators share one fixed point cosine table, rather
+//	than calling cos() for every sample.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "stimulus.h"
+
+uint32_t	STIMULUS::phase_step(double hz) {
+	return (uint32_t)(int64_t)llround(hz / ADC_RATE_HZ * 4294967296.0);
+}
+
+//
+// NCOTBL
+// {{{
+int16_t	NCOTBL::m_tbl[1<<NCOTBL::LGSIZE];
+
+void	NCOTBL::fill(void) {
+	const	unsigned	N = (1u<<LGSIZE);
+
+	// Each entry holds the value at the center of the range of phases
+	// that map to it
+	for(unsigned k=0; k<N; k++)
+		m_tbl[k] = (int16_t)lround(32767.0 * cos(2.0*M_PI*(k+0.5)/N));
+}
+
+void	NCOTBL::build(void) {
+	// Filled once, the first time through.  Since the initialization of
+	// a static is thread safe, simulations in several threads may all
+	// start at once.
+	static	const	bool	built = (fill(), true);
+	(void)built;
+}
+// }}}
+
+//
+// CHIRP
+// {{{
+CHIRP::CHIRP(void) {
+	NCOTBL::build();
+
+	m_phase = 0;
+
+	double	initial_step = 1.0/23/1024.0;
+	initial_step *= (1<<30)*4.;
+	m_step = (unsigned)initial_step;
+
+	double	initial_sweep = 1.0/23./1024.0;
+	initial_sweep *= initial_sweep;
+	initial_sweep *= (1<<30)*4.;
+	m_dstep = (unsigned)initial_sweep;
+}
+
+CHIRP::CHIRP(double start_hz, double hz_per_second) {
+	NCOTBL::build();
+
+	m_phase = 0;
+	m_step  = phase_step(start_hz);
+	m_dstep = phase_step(hz_per_second / ADC_RATE_HZ);
+}
+
+int	CHIRP::sample(void) {
+	m_phase += m_step;
+	m_step  += m_dstep;
+
+	return clip((NCOTBL::cosv(m_phase) + 8) >> (16-ADC_BITS));
+}
+
+void	CHIRP::save(FILE *fp) const {
+	uint32_t	v[3] = { m_phase, m_step, m_dstep };
+
+	fwrite(v, sizeof(v), 1, fp);
+}
+
+bool	CHIRP::restore(FILE *fp) {
+	uint32_t	v[3];
+
+	if (fread(v, sizeof(v), 1, fp) != 1)
+		return false;
+	m_phase = v[0]; m_step = v[1]; m_dstep = v[2];
+	return true;
+}
+// }}}
+
+//
+// TONES
+// {{{
+void	TONES::add(double hz, double amplitude) {
+	NCOTBL::build();
+
+	assert(m_ntones < MAXTONES);
+	m_phase[m_ntones] = 0;
+	m_step[m_ntones]  = phase_step(hz);
+	m_amp[m_ntones]   = (int)lround(amplitude * 32767.0);
+	m_ntones++;
+}
+
+int	TONES::sample(void) {
+	int64_t	acc = 0;
+
+	for(int k=0; k<m_ntones; k++) {
+		acc += (int64_t)m_amp[k] * NCOTBL::cosv(m_phase[k]);
+		m_phase[k] += m_step[k];
+	}
+
+	// Q30 to A/D units
+	return clip((int)((acc + (1<<(30-ADC_BITS))) >> (31-ADC_BITS)));
+}
+
+void	TONES::save(FILE *fp) const {
+	fwrite(&m_ntones, sizeof(m_ntones), 1, fp);
+	fwrite(m_phase, sizeof(m_phase[0]), m_ntones, fp);
+}
+
+bool	TONES::restore(FILE *fp) {
+	int	n;
+
+	if (fread(&n, sizeof(n), 1, fp) != 1 || n != m_ntones)
+		return false;
+	return fread(m_phase, sizeof(m_phase[0]), n, fp) == (size_t)n;
+}
+// }}}
+
+//
+// NOISE
+// {{{
+NOISE::NOISE(double amplitude, uint64_t seed) {
+	m_sigma = amplitude * (1<<(ADC_BITS-1));
+	m_state = (seed) ? seed : 1;
+}
+
+uint64_t	NOISE::rand64(void) {
+	// xorshift64*
+	m_state ^= m_state >> 12;
+	m_state ^= m_state << 25;
+	m_state ^= m_state >> 27;
+	return m_state * 0x2545f4914f6cdd1dull;
+}
+
+int	NOISE::sample(void) {
+	double	u1, u2;
+
+	// Box-Muller, using only one of the two values it produces
+	u1 = ((rand64() >> 11) + 1.0) / 9007199254740993.0;
+	u2 = (rand64() >> 11) / 9007199254740992.0;
+	return clip((int)lround(m_sigma * sqrt(-2.0*log(u1))
+						* cos(2.0*M_PI*u2)));
+}
+
+void	NOISE::save(FILE *fp) const {
+	fwrite(&m_state, sizeof(m_state), 1, fp);
+}
+
+bool	NOISE::restore(FILE *fp) {
+	return fread(&m_state, sizeof(m_state), 1, fp) == 1;
+}
+// }}}
+
+//
+// IMPULSE
+// {{{
+IMPULSE::IMPULSE(unsigned period, double amplitude) {
+	m_period = (period) ? period : 1;
+	m_count  = 0;
+	m_amp    = clip((int)lround(amplitude * (1<<(ADC_BITS-1))));
+}
+
+int	IMPULSE::sample(void) {
+	int	v = (m_count == 0) ? m_amp : 0;
+
+	if (++m_count >= m_period)
+		m_count = 0;
+	return v;
+}
+
+void	IMPULSE::save(FILE *fp) const {
+	fwrite(&m_count, sizeof(m_count), 1, fp);
+}
+
+bool	IMPULSE::restore(FILE *fp) {
+	return fread(&m_count, sizeof(m_count), 1, fp) == 1;
+}
+// }}}
+
+//
+// PCMFILE
+// {{{
+static	unsigned	le16(const unsigned char *p) {
+	return p[0] | (p[1] << 8);
+}
+
+static	unsigned	le32(const unsigned char *p) {
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned)p[3] << 24);
+}
+
+PCMFILE::PCMFILE(const char *fname, double rate, bool loop) {
+	int		fd;
+	struct stat	sb;
+	const unsigned char	*raw;
+
+	m_data = NULL;
+	m_map  = NULL;
+	m_maplen = 0;
+	m_nsamples = 0;
+	m_stride = 1;
+	m_pos  = 0;
+	m_step = 0;
+	m_loop = loop;
+
+	fd = open(fname, O_RDONLY);
+	if (fd < 0 || fstat(fd, &sb) != 0) {
+		fprintf(stderr, "ERR: Could not open %s\n", fname);
+		perror("O/S Err:");
+		if (fd >= 0)
+			close(fd);
+		return;
+	}
+
+	m_maplen = sb.st_size;
+	if (m_maplen < 2) {
+		fprintf(stderr, "ERR: %s is empty\n", fname);
+		close(fd);
+		return;
+	}
+
+	m_map = mmap(NULL, m_maplen, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (m_map == MAP_FAILED) {
+		fprintf(stderr, "ERR: Could not map %s\n", fname);
+		perror("O/S Err:");
+		m_map = NULL;
+		return;
+	}
+	// We'll read the file from front to back, hardly ever returning
+	madvise(m_map, m_maplen, MADV_SEQUENTIAL);
+
+	raw = (const unsigned char *)m_map;
+	if (m_maplen >= 12 && memcmp(raw, "RIFF", 4) == 0
+				&& memcmp(&raw[8], "WAVE", 4) == 0) {
+		// WAV file: walk the chunks, looking for the format and data
+		// {{{
+		size_t		pos = 12;
+		unsigned	channels = 0, bits = 0, srate = 0;
+
+		while(pos + 8 <= m_maplen) {
+			const unsigned char	*chunk = &raw[pos];
+			size_t	ln = le32(&chunk[4]);
+
+			if (pos + 8 + ln > m_maplen)
+				ln = m_maplen - pos - 8;
+
+			if (memcmp(chunk, "fmt ", 4) == 0 && ln >= 16) {
+				unsigned	fmt = le16(&chunk[8]);
+
+				channels = le16(&chunk[10]);
+				srate    = le32(&chunk[12]);
+				bits     = le16(&chunk[22]);
+				if ((fmt != 1 && fmt != 0xfffe)||(bits != 16)
+							||(channels == 0)) {
+					fprintf(stderr, "ERR: %s is not 16-bit PCM\n", fname);
+					return;
+				}
+			} else if (memcmp(chunk, "data", 4) == 0 && channels) {
+				m_data = (const int16_t *)&chunk[8];
+				m_stride = channels;
+				m_nsamples = ln / (2*channels);
+				break;
+			}
+
+			pos += 8 + ln + (ln & 1);
+		}
+
+		if (!m_data) {
+			fprintf(stderr, "ERR: No audio found in %s\n", fname);
+			return;
+		}
+
+		if (rate <= 0)
+			rate = srate;
+		// }}}
+	} else {
+		// Raw, mono, PCM
+		m_data = (const int16_t *)raw;
+		m_nsamples = m_maplen / 2;
+		if (rate <= 0)
+			rate = ADC_RATE_HZ;
+	}
+
+	if (m_nsamples == 0) {
+		m_data = NULL;
+		fprintf(stderr, "ERR: No audio found in %s\n", fname);
+		return;
+	}
+
+	// m_pos counts samples in 32.32 fixed point
+	if (m_nsamples >= (1ull << 32)) {
+		m_data = NULL;
+		fprintf(stderr, "ERR: %s is too long, 2^32 samples or more\n",
+			fname);
+		return;
+	}
+
+	m_step = (uint64_t)llround(rate / ADC_RATE_HZ * 4294967296.0);
+}
+
+PCMFILE::~PCMFILE(void) {
+	if (m_map)
+		munmap(m_map, m_maplen);
+}
+
+int	PCMFILE::sample(void) {
+	uint64_t	idx = m_pos >> 32;
+	int		s0, s1, v;
+
+	if (!m_data)
+		return 0;
+
+	if (idx >= m_nsamples) {
+		if (!m_loop)
+			return 0;
+		m_pos %= (m_nsamples << 32);
+		idx = m_pos >> 32;
+	}
+
+	// Linearly interpolate between this sample and the next
+	s0 = m_data[idx * m_stride];
+	if (idx + 1 < m_nsamples)
+		s1 = m_data[(idx+1) * m_stride];
+	else
+		s1 = (m_loop) ? m_data[0] : s0;
+	v = s0 + (int)(((int64_t)(s1 - s0) * (int64_t)((m_pos >> 16) & 0x0ffff)) >> 16);
+	m_pos += m_step;
+
+	// Sixteen bits down to the A/D's width
+	return clip(v >> (16-ADC_BITS));
+}
+
+void	PCMFILE::save(FILE *fp) const {
+	fwrite(&m_pos, sizeof(m_pos), 1, fp);
+}
+
+bool	PCMFILE::restore(FILE *fp) {
+	return fread(&m_pos, sizeof(m_pos), 1, fp) == 1;
+}
+// }}}
+
+//
+// STIMSUM
+// {{{
+STIMSUM::~STIMSUM(void) {
+	for(int k=0; k<m_nsrcs; k++)
+		delete m_src[k];
+}
+
+void	STIMSUM::add(STIMULUS *s) {
+	assert(m_nsrcs < MAXSRCS);
+	m_src[m_nsrcs++] = s;
+}
+
+int	STIMSUM::sample(void) {
+	int	v = 0;
+
+	for(int k=0; k<m_nsrcs; k++)
+		v += m_src[k]->sample();
+	return clip(v);
+}
+
+void	STIMSUM::save(FILE *fp) const {
+	for(int k=0; k<m_nsrcs; k++)
+		m_src[k]->save(fp);
+}
+
+bool	STIMSUM::restore(FILE *fp) {
+	for(int k=0; k<m_nsrcs; k++)
+		if (!m_src[k]->restore(fp))
+			return false;
+	return true;
+}
+// }}}
+
+//
+// make_stimulus
+// {{{
+// Parses a number from the field following the next ':', if there is one
+static	bool	nextarg(char *&ptr, double &v) {
+	char	*end;
+
+	if (!ptr || *ptr != ':')
+		return false;
+	v = strtod(ptr+1, &end);
+	if (end == ptr+1) {
+		fprintf(stderr, "ERR: Bad stimulus argument, %s\n", ptr+1);
+		ptr = NULL;
+		return false;
+	}
+	ptr = end;
+	return true;
+}
+
+static	STIMULUS *make_one(char *term) {
+	char	*ptr = strchr(term, ':');
+	double	a, b;
+	STIMULUS *s = NULL;
+
+	if (!ptr)
+		ptr = term + strlen(term);
+
+	if (strncmp(term, "chirp", 5) == 0 && ptr-term == 5) {
+		if (nextarg(ptr, a)) {
+			if (!nextarg(ptr, b))
+				b = 0;
+			s = new CHIRP(a, b);
+		} else
+			s = new CHIRP();
+	} else if (strncmp(term, "tone", 4) == 0 && ptr-term == 4) {
+		TONES	*t = new TONES();
+
+		if (!nextarg(ptr, a)) {
+			delete t;
+			fprintf(stderr, "ERR: tone:<hz> needs a frequency\n");
+			return NULL;
+		}
+		if (!nextarg(ptr, b))
+			b = 1.0;
+		t->add(a, b);
+		s = t;
+	} else if (strncmp(term, "noise", 5) == 0 && ptr-term == 5) {
+		if (!nextarg(ptr, a)) {
+			fprintf(stderr, "ERR: noise:<amplitude> needs an amplitude\n");
+			return NULL;
+		}
+		if (!nextarg(ptr, b))
+			b = 1;
+		s = new NOISE(a, (uint64_t)b);
+	} else if (strncmp(term, "impulse", 7) == 0 && ptr-term == 7) {
+		if (!nextarg(ptr, a)) {
+			fprintf(stderr, "ERR: impulse:<period> needs a period\n");
+			return NULL;
+		}
+		if (!nextarg(ptr, b))
+			b = 1.0;
+		s = new IMPULSE((unsigned)a, b);
+	} else if (strncmp(term, "file", 4) == 0 && ptr-term == 4 && *ptr) {
+		// file:<name>[:<rate>].  The name itself may contain colons,
+		// so only a number following the last one is taken as a rate
+		char	*fname = ptr+1, *last = strrchr(fname, ':'), *end;
+		PCMFILE	*p;
+
+		a = 0;
+		if (last) {
+			a = strtod(last+1, &end);
+			if (end != last+1 && *end == '\0')
+				*last = '\0';
+			else
+				a = 0;
+		}
+
+		p = new PCMFILE(fname, a);
+		if (!p->ok()) {
+			delete p;
+			return NULL;
+		}
+		return p;
+	} else {
+		fprintf(stderr, "ERR: Unknown stimulus, %s\n", term);
+		return NULL;
+	}
+
+	if (!ptr || *ptr) {
+		fprintf(stderr, "ERR: Bad stimulus, %s\n", term);
+		delete s;
+		return NULL;
+	}
+
+	return s;
+}
+
+STIMULUS *make_stimulus(const char *spec) {
+	char	*str = strdup(spec), *term, *save = NULL;
+	STIMSUM	*sum = new STIMSUM();
+	STIMULUS *result = NULL;
+
+	for(term = strtok_r(str, "+", &save); term;
+				term = strtok_r(NULL, "+", &save)) {
+		STIMULUS	*s = make_one(term);
+
+		if (!s || sum->m_nsrcs >= STIMSUM::MAXSRCS) {
+			delete	s;
+			delete	sum;
+			free(str);
+			return NULL;
+		}
+		sum->add(s);
+	}
+	free(str);
+
+	if (sum->m_nsrcs == 1) {
+		// No need for the sum of just one thing
+		result = sum->m_src[0];
+		sum->m_nsrcs = 0;
+		delete sum;
+	} else if (sum->m_nsrcs == 0) {
+		fprintf(stderr, "ERR: Empty stimulus\n");
+		delete sum;
+	} else
+		result = sum;
+
+	return result;
+}
+// }}}
@@ -0,0 +1,220 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/stimulus.h
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Test signals, to be fed through the simulated microphone's A/D
+//		(MICNCO) into the design: swept and fixed tones, noise,
+//	impulses, and audio read from a file.  Each is a STIMULUS, and so any
+//	of them may be plugged into MICNCO--or added together, and the sum
+//	plugged in instead.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#ifndef	STIMULUS_H
+#define	STIMULUS_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define	ADC_BITS	12
+#define	ADC_MAX		((1<<(ADC_BITS-1))-1)
+#define	ADC_MIN		(-(1<<(ADC_BITS-1)))
+// The rate the design samples the microphone's A/D at
+#define	ADC_RATE_HZ	1e6
+
+// STIMULUS
+// {{{
+// The base class of all stimulus generators.  sample() is called once per
+// A/D sample, and returns the next sample as a signed number between
+// ADC_MIN and ADC_MAX.
+class	STIMULUS {
+public:
+	virtual	~STIMULUS(void) {}
+	virtual	int	sample(void) = 0;
+
+	// Checkpoint support
+	virtual	void	save(FILE *fp) const {}
+	virtual	bool	restore(FILE *fp) { return true; }
+
+	// Converts a frequency in Hz to a 32-bit phase step per sample
+	static	uint32_t	phase_step(double hz);
+
+	// Clips a value to the range of the A/D
+	static	int	clip(int v) {
+		return (v > ADC_MAX) ? ADC_MAX : ((v < ADC_MIN) ? ADC_MIN : v);
+	}
+};
+// }}}
+
+// NCOTBL
+// {{{
+// A (shared) fixed point table of cosine values, indexed by the top
+// NCOTBL::LGSIZE bits of a 32-bit phase.  Values are scaled to +/- 32767.
+class	NCOTBL {
+public:
+	static	const	unsigned	LGSIZE = 14;
+	static	int16_t	m_tbl[1<<LGSIZE];
+
+	static	void	fill(void);
+	static	void	build(void);
+	static	int	cosv(uint32_t phase) {
+		return m_tbl[phase >> (32-LGSIZE)];
+	}
+};
+// }}}
+
+// CHIRP
+// {{{
+// A full scale cosine, whose frequency increases linearly with time.  The
+// default chirp sweeps at the rates MICNCO always has, but, like the other
+// stimuli, takes its samples from the shared table rather than cos(), and so
+// may differ from MICNCO's original by an LSB.
+class	CHIRP : public STIMULUS {
+public:
+	uint32_t	m_phase, m_step, m_dstep;
+
+	CHIRP(void);
+	CHIRP(double start_hz, double hz_per_second);
+	void	step(uint32_t s) { m_step = s; }
+	int	sample(void);
+	void	save(FILE *fp) const;
+	bool	restore(FILE *fp);
+};
+// }}}
+
+// TONES
+// {{{
+// The sum of (up to MAXTONES) fixed frequency cosines.  Amplitudes are
+// given as a fraction of full scale.
+class	TONES : public STIMULUS {
+public:
+	static	const	int	MAXTONES = 16;
+	int		m_ntones;
+	uint32_t	m_phase[MAXTONES], m_step[MAXTONES];
+	int		m_amp[MAXTONES];	// Q15
+
+	TONES(void) : m_ntones(0) {}
+	void	add(double hz, double amplitude);
+	int	sample(void);
+	void	save(FILE *fp) const;
+	bool	restore(FILE *fp);
+};
+// }}}
+
+// NOISE
+// {{{
+// White, Gaussian noise, from a seeded (and hence repeatable) generator.
+// The amplitude is the standard deviation, as a fraction of full scale.
+class	NOISE : public STIMULUS {
+public:
+	uint64_t	m_state;
+	double		m_sigma;
+
+	NOISE(double amplitude, uint64_t seed = 1);
+	uint64_t	rand64(void);
+	int	sample(void);
+	void	save(FILE *fp) const;
+	bool	restore(FILE *fp);
+};
+// }}}
+
+// IMPULSE
+// {{{
+// A single sample of the given amplitude every period samples, zero otherwise
+class	IMPULSE : public STIMULUS {
+public:
+	unsigned	m_period, m_count;
+	int		m_amp;
+
+	IMPULSE(unsigned period, double amplitude = 1.0);
+	int	sample(void);
+	void	save(FILE *fp) const;
+	bool	restore(FILE *fp);
+};
+// }}}
+
+// PCMFILE
+// {{{
+// Samples read from a file of 16-bit signed, little endian, PCM--either raw
+// or within a WAV file.  Only the first channel of a WAV file is used.  The
+// file is memory mapped rather than read, so it may be as long as 2^32 samples.
+// Samples are (linearly) interpolated to the A/D sample rate.  Once the end
+// of the file is reached, it starts over from the beginning--unless loop is
+// false, in which case the rest of the input is zero.
+class	PCMFILE : public STIMULUS {
+public:
+	const int16_t	*m_data;
+	void		*m_map;
+	size_t		m_maplen;
+	uint64_t	m_nsamples, m_stride;	// Stride, in int16_t's
+	uint64_t	m_pos, m_step;		// 32.32 fixed point
+	bool		m_loop;
+
+	// rate is the file's sample rate.  For WAV files, zero means
+	// use the rate given in the file.
+	PCMFILE(const char *fname, double rate = 0, bool loop = true);
+	~PCMFILE(void);
+	bool	ok(void) const { return m_data != NULL; }
+	bool	done(void) const { return !m_loop && (m_pos>>32) >= m_nsamples;}
+	int	sample(void);
+	void	save(FILE *fp) const;
+	bool	restore(FILE *fp);
+};
+// }}}
+
+// STIMSUM
+// {{{
+// The (clipped) sum of several other stimuli, which it then owns
+class	STIMSUM : public STIMULUS {
+public:
+	static	const	int	MAXSRCS = 8;
+	int		m_nsrcs;
+	STIMULUS	*m_src[MAXSRCS];
+
+	STIMSUM(void) : m_nsrcs(0) {}
+	~STIMSUM(void);
+	void	add(STIMULUS *s);
+	int	sample(void);
+	void	save(FILE *fp) const;
+	bool	restore(FILE *fp);
+};
+// }}}
+
+// Creates a stimulus from a text description, such as
+//	"chirp", "chirp:<start hz>:<hz per second>",
+//	"tone:<hz>[:<amplitude>]", "noise:<amplitude>[:<seed>]",
+//	"impulse:<period>[:<amplitude>]", "file:<filename>[:<rate>]".
+// Several of these may be added together, separated by '+'.  Returns NULL
+// (after printing why) on any error.
+extern	STIMULUS *make_stimulus(const char *spec);
+
+#endif
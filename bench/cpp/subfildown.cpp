@@ -0,0 +1,276 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/subfildown.cpp
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	A bit exact model of rtl/subfildown.v.  See subfildown.h.
+//
+//	The RTL reads its data memory from the oldest sample to the newest,
+//	and multiplies them by its coefficients in order, so that coefficient
+//	k is applied to the sample M-k samples before the one that started
+//	the sum (M = 1<<LGNCOEFFS).  The sample that started the sum is not
+//	itself a part of it, and the sum isn't output until the next one is
+//	started, NDOWN samples later.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "readmemh.h"
+#include "subfildown.h"
+
+// Taps per block: the width of the widest vector we use, in 16-bit values
+static	const	unsigned	BLOCK = 16;
+
+// Products summed into each 32-bit lane of dot() per block: AVX2 has eight
+// lanes per block, the portable loop eight per pass, but SSE2 only four.
+#if defined(__AVX2__) || !defined(__SSE2__)
+static	const	unsigned	LANE_PRODUCTS = BLOCK / 8;
+#else
+static	const	unsigned	LANE_PRODUCTS = BLOCK / 4;
+#endif
+
+// dot()
+// {{{
+// The sum of n products of 16-bit values, where no more than spill blocks
+// of products may be summed in 32-bits without overflowing.  n must be a
+// multiple of BLOCK.
+static	int64_t	dot(const int16_t *x, const int16_t *c, unsigned n,
+			unsigned spill) {
+	int64_t		sum = 0;
+	unsigned	k = 0;
+
+	while(k < n) {
+		unsigned	end = k + spill * BLOCK;
+		int32_t		lanes[8];
+
+		if (end > n)
+			end = n;
+#if defined(__AVX2__)
+		// {{{
+		__m256i	acc = _mm256_setzero_si256();
+
+		for(; k<end; k+=BLOCK)
+			acc = _mm256_add_epi32(acc, _mm256_madd_epi16(
+				_mm256_loadu_si256((const __m256i *)&x[k]),
+				_mm256_load_si256((const __m256i *)&c[k])));
+		_mm256_storeu_si256((__m256i *)lanes, acc);
+		for(int i=0; i<8; i++)
+			sum += lanes[i];
+		// }}}
+#elif defined(__SSE2__)
+		// {{{
+		__m128i	acc = _mm_setzero_si128();
+
+		for(; k<end; k+=8)
+			acc = _mm_add_epi32(acc, _mm_madd_epi16(
+				_mm_loadu_si128((const __m128i *)&x[k]),
+				_mm_load_si128((const __m128i *)&c[k])));
+		_mm_storeu_si128((__m128i *)lanes, acc);
+		for(int i=0; i<4; i++)
+			sum += lanes[i];
+		// }}}
+#else
+		// {{{
+		// Written so that the compiler may vectorize it (NEON's vmlal,
+		// for example) on its own
+		for(int i=0; i<8; i++)
+			lanes[i] = 0;
+		for(; k<end; k+=8)
+			for(int i=0; i<8; i++)
+				lanes[i] += x[k+i] * c[k+i];
+		for(int i=0; i<8; i++)
+			sum += lanes[i];
+		// }}}
+#endif
+	}
+
+	return sum;
+}
+// }}}
+
+SUBFILDOWN::SUBFILDOWN(int iw, int ow, int cw, int ndown, int ncoeffs,
+		int shift) : m_iw(iw), m_ow(ow), m_cw(cw), m_ndown(ndown),
+		m_ncoeffs(ncoeffs), m_shift(shift) {
+	// {{{
+	unsigned	alloc;
+
+	for(m_lgn = 0; (1 << m_lgn) < ncoeffs; m_lgn++)
+		;
+	m_len = 1u << m_lgn;
+	m_aw  = iw + cw + m_lgn;
+
+	// Each 32-bit lane sums LANE_PRODUCTS products, each of at most
+	// 2^(IW+CW-2), per block.  Keep the lane's sum within 2^30.
+	m_spill = (iw + cw <= 32)
+		? (unsigned)((1ull << (32 - iw - cw)) / LANE_PRODUCTS) : 0;
+
+	m_coef = m_hist = NULL;
+	m_ok = !(iw > 16 || cw > 16 || m_aw - shift <= ow || m_aw > 64
+			|| m_spill == 0);
+	if (!m_ok) {
+		fprintf(stderr, "ERR: SUBFILDOWN(IW=%d,OW=%d,CW=%d,SHIFT=%d) "
+			"isn't supported\n", iw, ow, cw, shift);
+		return;
+	}
+
+	// Round the taps up to a whole number of blocks.  The extra
+	// coefficients are zero, so it doesn't matter what they're multiplied
+	// by, so long as it's there to read.
+	alloc  = (m_len + BLOCK-1) & -BLOCK;
+	m_coef = (int16_t *)aligned_alloc(32, alloc * sizeof(int16_t));
+	m_hist = new int16_t[m_len + alloc];
+	memset(m_coef, 0, alloc * sizeof(int16_t));
+	memset(m_hist, 0, (m_len + alloc) * sizeof(int16_t));
+
+	reset();
+}
+// }}}
+
+SUBFILDOWN::~SUBFILDOWN(void) {
+	free(m_coef);
+	delete[] m_hist;
+}
+
+bool	SUBFILDOWN::load(const char *fname) {
+	// {{{
+	unsigned	*v;
+	int		n;
+
+	if (!m_ok)
+		return false;
+
+	v = new unsigned[m_len]();
+	if ((n = readmemh(fname, v, m_len)) < m_ncoeffs) {
+		if (n >= 0)
+			fprintf(stderr, "ERR: %s holds %d coefficients, not %d\n",
+				fname, n, m_ncoeffs);
+		delete[] v;
+		return false;
+	}
+
+	for(int k=0; k<m_ncoeffs; k++)
+		m_coef[k] = sbits(v[k], m_cw);
+	delete[] v;
+	return true;
+}
+// }}}
+
+void	SUBFILDOWN::load(const int *coeffs) {
+	// {{{
+	if (!m_ok)
+		return;
+	for(int k=0; k<m_ncoeffs; k++)
+		m_coef[k] = sbits(coeffs[k], m_cw);
+}
+// }}}
+
+void	SUBFILDOWN::reset(void) {
+	// {{{
+	memset(m_hist, 0, 2 * m_len * sizeof(int16_t));
+	m_wr = 0;
+	// The RTL starts with first_sample set
+	m_countdown = 0;
+	m_valid = false;
+	m_acc = 0;
+}
+// }}}
+
+int	SUBFILDOWN::round(uint64_t acc) const {
+	// {{{
+	// Convergent rounding, as in the SHIFT_OUTPUT branch of the RTL
+	const	uint64_t	mask = (m_aw < 64) ? (1ul << m_aw)-1 : ~0ul;
+	uint64_t	pre, rounded;
+	int		lsb = m_aw - m_ow;	// First bit dropped
+	bool		sgn, presgn, rsgn;
+
+	pre = (acc << m_shift) & mask;
+	if ((pre >> (lsb-1)) & 1)
+		rounded = pre + (1ul << (lsb-1));
+	else
+		rounded = pre + (1ul << (lsb-1)) - 1;
+	rounded &= mask;
+
+	sgn    = (acc     >> (m_aw-1)) & 1;
+	presgn = (pre     >> (m_aw-1)) & 1;
+	rsgn   = (rounded >> (m_aw-1)) & 1;
+	if ((sgn && !presgn) || (!sgn && rsgn))
+		// Saturate
+		return (sgn) ? -(1 << (m_ow-1)) : (1 << (m_ow-1)) - 1;
+	return sbits((unsigned)(rounded >> lsb), m_ow);
+}
+// }}}
+
+bool	SUBFILDOWN::operator()(int s, int &result) {
+	// {{{
+	bool	r = false;
+
+	if (m_countdown == 0) {
+		// The RTL starts a new sum with this sample, over the m_len
+		// samples before it, oldest first.  The sum before it goes out.
+		if (m_valid) {
+			result = round(m_acc);
+			r = true;
+		}
+		m_acc = (uint64_t)dot(&m_hist[m_wr], m_coef,
+				(m_len + BLOCK-1) & -BLOCK, m_spill);
+		if (m_aw < 64)
+			m_acc &= (1ul << m_aw)-1;
+		m_valid = true;
+		m_countdown = m_ndown;
+	}
+	m_countdown--;
+
+	// Keep two copies of every sample, so that the last m_len are always
+	// in one (unwrapped) piece
+	m_hist[m_wr] = m_hist[m_wr + m_len] = sbits(s, m_iw);
+	if (++m_wr >= m_len)
+		m_wr = 0;
+
+	return r;
+}
+// }}}
+
+int	SUBFILDOWN::apply(const int *in, int n, int *out) {
+	// {{{
+	int	nout = 0;
+
+	for(int k=0; k<n; k++)
+		if ((*this)(in[k], out[nout]))
+			nout++;
+	return nout;
+}
+// }}}
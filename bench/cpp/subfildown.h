@@ -0,0 +1,107 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/subfildown.h
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	A bit exact model of rtl/subfildown.v, the decimating filter
+//		between the A/D and the window function.  Given the same
+//	parameters, coefficients and samples, it produces the same outputs as
+//	the RTL, in the same order--only (very) much faster.  It may be used
+//	to check the RTL, or in its place when only the stages following it
+//	are of interest.
+//
+//	Like the RTL, the model only computes those outputs it keeps: one for
+//	every NDOWN samples.  Each is the sum of NCOEFFS products, taken
+//	sixteen (AVX2) or eight (SSE2) at a time.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#ifndef	SUBFILDOWN_H
+#define	SUBFILDOWN_H
+
+#include <stdint.h>
+
+// SUBFILDOWN
+// {{{
+// One subfildown filter, with the parameters (and coefficients) of one of
+// the instances within the design.  The defaults are those of main.v.
+// The DDR3 design (hdmiddr.v) would be
+//
+//	SUBFILDOWN	fil(12, 21, 12, 125, 4095, 0);
+//	fil.load("subfildownlow.hex");
+//
+class	SUBFILDOWN {
+	int		m_iw, m_ow, m_cw, m_ndown, m_ncoeffs, m_shift,
+			m_lgn, m_aw;
+	unsigned	m_len,		// 1<<LGNCOEFFS, the RTL's memory size
+			m_spill;	// Blocks of taps per 32-bit partial sum
+	int16_t		*m_coef,	// m_len coefficients, zero padded
+			*m_hist;	// The last m_len samples, twice over
+	unsigned	m_wr,		// Where the next sample goes
+			m_countdown;	// Samples until the next output
+	bool		m_valid,	// True once m_acc holds a full sum
+			m_ok;		// False if built with bad parameters
+	uint64_t	m_acc;		// The accumulator, AW bits of it
+
+	// The RTL's rounding and saturation, from AW bits to OW
+	int	round(uint64_t acc) const;
+public:
+	SUBFILDOWN(int iw=12, int ow=20, int cw=12, int ndown=23,
+			int ncoeffs=1023, int shift=2);
+	~SUBFILDOWN(void);
+
+	// False if the constructor was given parameters the model doesn't
+	// support.  Such a filter can't be loaded, and mustn't be used.
+	bool	ok(void) const { return m_ok; }
+
+	// Loads the coefficients from a hex file, as INITIAL_COEFFS would,
+	// or from an array of ncoeffs (CW bit) values
+	bool	load(const char *fname);
+	void	load(const int *coeffs);
+
+	// Returns to the state the RTL is in at power up
+	void	reset(void);
+
+	// Accepts the next sample (the low IW bits of s) as the RTL would on
+	// i_ce.  Returns true, and the filter's output in result, on those
+	// samples where the RTL would (shortly) raise o_ce.
+	bool	operator()(int s, int &result);
+
+	// Filters n samples, writing the (up to n/NDOWN+1) results to out,
+	// and returning how many were written
+	int	apply(const int *in, int n, int *out);
+
+	int	ndown(void) const { return m_ndown; }
+	int	ow(void) const { return m_ow; }
+};
+// }}}
+
+#endif
@@ -149,5 +149,24 @@ public:
 			return true;
 		return false;
 	}
+
+	void	save(FILE *fp) const {
+		unsigned long	v[4] = { m_increment_ps, m_now_ps,
+					m_last_posedge_ps, m_ticks };
+
+		fwrite(v, sizeof(v), 1, fp);
+	}
+
+	bool	restore(FILE *fp) {
+		unsigned long	v[4];
+
+		if (fread(v, sizeof(v), 1, fp) != 1)
+			return false;
+		m_increment_ps    = v[0];
+		m_now_ps          = v[1];
+		m_last_posedge_ps = v[2];
+		m_ticks           = v[3];
+		return true;
+	}
 };
 #endif
@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/tbsched.h
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	A scheduler for test benches with any number of clocks.  Each
+//		call to step() advances time straight to the next edge of
+//	any clock, evaluates the design exactly once, and then calls back into
+//	the test bench for every clock that just had a negative edge.
+//
+//	Calls into the test bench are made through the derived class type
+//	itself (the "curiously recurring template pattern"), rather than
+//	through virtual functions, so the compiler can inline them.  Adding
+//	another clock therefore costs one more TBCLOCK comparison per step,
+//	and an evaluation only when that clock actually has an edge.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#ifndef	TBSCHED_H
+#define	TBSCHED_H
+
+#include <stdio.h>
+#include <assert.h>
+#include "tbclock.h"
+
+//
+// TBSCHED<TB, NCLK>
+//
+// TB must derive from TBSCHED<TB, NCLK>, and provide (non-virtual):
+//
+//	void	set_clock(int k, int v)	Sets the design's input for clock k
+//	void	eval_edge(void)		Evaluates the design (once) after one
+//					or more clocks have changed, and
+//					records any trace
+//	void	negedge(int k)		Called following every negative edge
+//					of clock k, once the design has been
+//					evaluated.  New inputs for the design
+//					may be set here.
+//
+template <class TB, int NCLK>	class TBSCHED {
+public:
+	TBCLOCK		m_clock[NCLK];
+	unsigned long	m_time_ps;
+
+	TBSCHED(void) : m_time_ps(0) {}
+
+	// step()
+	// {{{
+	// Advances time to the next edge of any clock, sets all of the
+	// clock inputs, evaluates the design once, and then calls negedge()
+	// for every clock that just fell.
+	void	step(void) {
+		TB		&tb = *static_cast<TB *>(this);
+		unsigned long	mintime = m_clock[0].time_to_edge();
+
+		for(int k=1; k<NCLK; k++) {
+			unsigned long	t = m_clock[k].time_to_edge();
+			if (t < mintime)
+				mintime = t;
+		}
+
+		assert(mintime > 1);
+
+		for(int k=0; k<NCLK; k++)
+			tb.set_clock(k, m_clock[k].advance(mintime));
+		m_time_ps += mintime;
+
+		tb.eval_edge();
+
+		for(int k=0; k<NCLK; k++)
+			if (m_clock[k].falling_edge())
+				tb.negedge(k);
+	}
+	// }}}
+
+	void	save_clocks(FILE *fp) const {
+		fwrite(&m_time_ps, sizeof(m_time_ps), 1, fp);
+		for(int k=0; k<NCLK; k++)
+			m_clock[k].save(fp);
+	}
+
+	bool	restore_clocks(FILE *fp) {
+		if (fread(&m_time_ps, sizeof(m_time_ps), 1, fp) != 1)
+			return false;
+		for(int k=0; k<NCLK; k++)
+			if (!m_clock[k].restore(fp))
+				return false;
+		return true;
+	}
+};
+
+#endif	// TBSCHED_H
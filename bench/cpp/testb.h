@@ -12,6 +12,15 @@
 //	running at.  In particular, the pixel clock speed is set and adjusted
 //	elsewhere.
 //
+//	The clocks themselves are stepped by TBSCHED (tbsched.h).  The test
+//	bench deriving from TESTB is given as the second template argument,
+//	TB, so that its sim_clk_tick() and sim_pixclk_tick() can be called
+//	directly rather than virtually.
+//
+//	Traces may be taken of the whole run, or of just a window of it.  See
+//	tracewin.h.  Build with TRACE_FST defined for FST traces rather than
+//	VCD.
+//
 // Creator:	Dan Gisselquist, Ph.D.
 //		Gisselquist Technology, LLC
 //
@@ -45,29 +54,74 @@
 #define	TESTB_H
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
+#include <sys/stat.h>
+#if	defined(NO_TRACE)
+// The design was Verilated without --trace, so nothing can be traced
+class	NOTRACE {
+public:
+	void	open(const char *fname) {}
+	void	close(void) {}
+	bool	isOpen(void) const { return false; }
+	void	dump(uint64_t t) {}
+	void	flush(void) {}
+};
+#define	TRACECLASS	NOTRACE
+#elif	defined(TRACE_FST)
+// The design must be Verilated with --trace-fst.  Add --trace-threads to
+// have Verilator write the trace from a separate thread.
+#include <verilated_fst_c.h>
+#define	TRACECLASS	VerilatedFstC
+#else
+#define	TRACE_VCD
 #include <verilated_vcd_c.h>
-#include "tbclock.h"
+#define	TRACECLASS	VerilatedVcdC
+#endif
+#include <verilated_save.h>
+#include "tbsched.h"
+#include "tracewin.h"
+#include "probes.h"
 
 #define	TBASSERT(TB,A) do { if (!(A)) { (TB).closetrace(); } assert(A); } while(0);
-#define	TRACE_VCD
 
-template <class VA>	class TESTB {
+template <class VA, class TB>	class TESTB : public TBSCHED<TB, 2> {
 public:
+#ifdef	ROOT_VERILATOR
+	// Each model has a context of its own, so that several may be
+	// simulated at once, each in a thread of its own
+	VerilatedContext	*m_context;
+#endif
 	VA		*m_core;
 	bool		m_changed;
-	VerilatedVcdC*	m_trace_vcd;
+	TRACECLASS	*m_trace;
 	bool		m_done;
-	unsigned long	m_time_ps;
-	TBCLOCK		m_clk;
-	TBCLOCK		m_pixclk;
+	TBCLOCK		&m_clk;
+	TBCLOCK		&m_pixclk;
+
+	// Named signals within the design, and the logic analyzer sampling
+	// them, if armed
+	PROBES		m_probes;
+
+	// Trace window state
+	TRACEWIN	m_tracewin;
+	char		*m_trace_name;
+	int		m_trace_seg, m_trace_nsegs;
+	unsigned long	m_trace_seg_ps, m_trace_flush_ps;
 
-	TESTB(void) {
+	TESTB(void) : m_clk(this->m_clock[0]), m_pixclk(this->m_clock[1]) {
+#ifdef	ROOT_VERILATOR
+		m_context = new VerilatedContext;
+		m_context->traceEverOn(true);
+		m_core = new VA(m_context);
+#else
+		Verilated::traceEverOn(true);
 		m_core = new VA;
-		m_time_ps   = 0ul;
-		m_trace_vcd = NULL;
+#endif
+		m_trace = NULL;
+		m_trace_name = NULL;
 		m_done      = false;
-		Verilated::traceEverOn(true);
 		m_core->i_clk = 0;
 		m_core->i_pixclk = 0;
 		eval(); // Get our initial values set properly.
@@ -75,94 +129,405 @@ public:
 		m_pixclk.init(6734);	//  148.50 MHz
 	}
 	virtual ~TESTB(void) {
-		if (m_trace_vcd)
-			m_trace_vcd->close();
+		closetrace();
+		// Runs any final blocks, before the model (and any profile
+		// data, if Verilated with --prof-pgo) is written out
+		m_core->final();
 		delete m_core;
 		m_core = NULL;
+#ifdef	ROOT_VERILATOR
+		delete m_context;
+#endif
 	}
 
-	virtual	void	openvcd(const char *vcdname) {
-		if (!m_trace_vcd) {
-			m_trace_vcd = new VerilatedVcdC;
-			m_core->trace(m_trace_vcd, 99);
-			m_trace_vcd->open(vcdname);
-			m_trace_vcd->spTrace()->set_time_resolution("ps");
-			m_trace_vcd->spTrace()->set_time_unit("ps");
+	// Passes any +verilator+ arguments on to the model
+	void	commandArgs(int argc, char **argv) {
+#ifdef	ROOT_VERILATOR
+		m_context->commandArgs(argc, argv);
+#else
+		Verilated::commandArgs(argc, argv);
+#endif
+	}
+
+	// Tracing
+	// {{{
+	// Traces everything from now on into trcname
+	virtual	void	opentrace(const char *trcname) {
+		tracewindow(trcname, NULL);
+	}
+
+	// tracewindow()
+	// {{{
+	// Traces only the window described by spec (see tracewin.h) into
+	// trcname.  If the window asks for a pre-trigger history, the design
+	// is traced all along into two files, <name>-0.<ext> and <name>-1.<ext>,
+	// each of which is rewritten in turn as the history grows stale.
+	// Once the window opens, the older of the two is renamed to
+	// <name>-pre.<ext>, and the newer one to trcname, which then continues
+	// on to the end of the window.  Between them, the two hold at least
+	// the history asked for.
+	bool	tracewindow(const char *trcname, const char *spec) {
+		TRACEWIN	&w = m_tracewin;
+
+		closetrace();
+#ifdef	NO_TRACE
+		fprintf(stderr, "ERR: Built without tracing, cannot trace %s\n",
+			trcname);
+		return false;
+#endif
+		if (!w.parse(spec))
+			return false;
+
+		if (w.m_on_name[0] && !(w.m_on
+				= static_cast<TB *>(this)->probe(w.m_on_name))){
+			fprintf(stderr, "ERR: Unknown signal, %s\n",
+				w.m_on_name);
+			return false;
+		}
+
+		if (w.m_off_name[0] && !(w.m_off
+				= static_cast<TB *>(this)->probe(w.m_off_name))){
+			fprintf(stderr, "ERR: Unknown signal, %s\n",
+				w.m_off_name);
+			return false;
 		}
+
+		fprintf(stderr, "Opening TRACE(%s)\n", trcname);
+		m_trace_name = strdup(trcname);
+		m_trace_seg = 0;
+		m_trace_nsegs = 0;
+		m_trace_flush_ps = this->m_time_ps + w.m_flush_ps;
+
+		if (w.immediate()) {
+			w.trigger(this->m_time_ps, m_clk.ticks());
+			trace_open(m_trace_name);
+		} else if (w.m_pre_ps > 0)
+			trace_segment();
+		return true;
+	}
+	// }}}
+
+	// Maps the names of any signals a trace window may start or stop on
+	// to those signals.  Any single byte signal in m_probes will do.
+	const unsigned char	*probe(const char *name) {
+		return m_probes.signal(name);
 	}
 
 	virtual	void	closetrace(void) {
-		if (m_trace_vcd) {
-			m_trace_vcd->close();
-			delete m_trace_vcd;
-			m_trace_vcd = NULL;
+		if (m_trace) {
+			m_trace->close();
+			delete m_trace;
+			m_trace = NULL;
+		}
+
+		if (m_trace_name) {
+			if (m_tracewin.m_state != TRACEWIN::TW_ON
+				&& m_tracewin.m_state != TRACEWIN::TW_DONE)
+				fprintf(stderr, "WARNING: The trace window for %s never opened\n", m_trace_name);
+			free(m_trace_name);
+			m_trace_name = NULL;
 		}
 	}
 
-	virtual	void	eval(void) {
-		m_core->eval();
+	// trace_file()
+	// {{{
+	// Generates the name of one of the files the pre-trigger history
+	// is kept in, by inserting -tag before the extension of the trace
+	// file's name
+	void	trace_file(char *buf, size_t len, const char *tag) const {
+		const char	*dot = strrchr(m_trace_name, '.');
+
+		if (!dot || strchr(dot, '/'))
+			snprintf(buf, len, "%s-%s", m_trace_name, tag);
+		else
+			snprintf(buf, len, "%.*s-%s%s",
+				(int)(dot - m_trace_name), m_trace_name,
+				tag, dot);
 	}
+	// }}}
 
-	virtual	void	tick(void) {
-		unsigned	mintime = m_clk.time_to_edge();
+	void	trace_open(const char *fname) {
+		if (!m_trace) {
+			m_trace = new TRACECLASS;
+#ifndef	NO_TRACE
+			m_core->trace(m_trace, 99);
+			m_trace->spTrace()->set_time_resolution("ps");
+			m_trace->spTrace()->set_time_unit("ps");
+#endif
+		}
 
-		if (m_pixclk.time_to_edge() < mintime)
-			mintime = m_pixclk.time_to_edge();
+		m_trace->open(fname);
+	}
 
-		assert(mintime > 1);
+	// trace_segment()
+	// {{{
+	// Starts a new pre-trigger history file, overwriting the oldest
+	void	trace_segment(void) {
+		char	fname[512], tag[8];
 
-		eval();
-		if (m_trace_vcd) m_trace_vcd->dump(m_time_ps+1);
+		if (m_trace && m_trace->isOpen()) {
+			m_trace->close();
+			m_trace_seg ^= 1;
+		}
 
-		m_core->i_clk = m_clk.advance(mintime);
-		m_core->i_pixclk = m_pixclk.advance(mintime);
+		snprintf(tag, sizeof(tag), "%d", m_trace_seg);
+		trace_file(fname, sizeof(fname), tag);
+		trace_open(fname);
+		m_trace_seg_ps = this->m_time_ps;
+		m_trace_nsegs++;
+	}
+	// }}}
 
-		m_time_ps += mintime;
+	// trace_trigger()
+	// {{{
+	// Called once the trace window opens, to keep the pre-trigger
+	// history (if any) and start the trace proper
+	void	trace_trigger(void) {
+		char	fname[512], tag[8];
 
-		eval();
-		if (m_trace_vcd) {
-			m_trace_vcd->dump(m_time_ps+1);
-			m_trace_vcd->flush();
+		if (!m_trace || !m_trace->isOpen()) {
+			trace_open(m_trace_name);
+			return;
 		}
 
-		if (m_clk.falling_edge()) {
-			m_changed = true;
-			sim_clk_tick();
+		if (m_trace_nsegs > 1) {
+			char	pre[512];
+
+			snprintf(tag, sizeof(tag), "%d", m_trace_seg^1);
+			trace_file(fname, sizeof(fname), tag);
+			trace_file(pre, sizeof(pre), "pre");
+			rename(fname, pre);
 		}
-		if (m_pixclk.falling_edge()) {
-			m_changed = true;
-			sim_pixclk_tick();
+
+		// Files may be renamed while open.  The trace continues into
+		// the same file, just under its final name.
+		snprintf(tag, sizeof(tag), "%d", m_trace_seg);
+		trace_file(fname, sizeof(fname), tag);
+		rename(fname, m_trace_name);
+	}
+	// }}}
+
+	// trace_step()
+	// {{{
+	void	trace_step(void) {
+		TRACEWIN	&w = m_tracewin;
+		unsigned long	t = this->m_time_ps;
+
+		if (w.m_state == TRACEWIN::TW_ON) {
+			if (w.stop(t, m_clk.ticks())) {
+				if (m_trace)
+					m_trace->dump(t);
+				closetrace();
+				return;
+			}
+		} else if (w.start(t, m_clk.ticks()))
+			trace_trigger();
+		else if (w.m_pre_ps > 0 && t - m_trace_seg_ps >= w.m_pre_ps)
+			trace_segment();
+
+		if (m_trace && m_trace->isOpen()) {
+			m_trace->dump(t);
+
+			// Flush every so often, but not on every step
+			if (t >= m_trace_flush_ps) {
+				m_trace->flush();
+				m_trace_flush_ps = t + w.m_flush_ps;
+			}
 		}
 	}
+	// }}}
+	// }}}
 
-	virtual	void	sim_clk_tick(void) {
-			// Your test fixture should over-ride this method.
-			// If you change any of the inputs to the design
-			// (i.e. w/in main.v), then set m_changed to true.
+	void	eval(void) {
+		m_core->eval();
+	}
+
+	// Callbacks from TBSCHED
+	// {{{
+	void	set_clock(int k, int v) {
+		if (k == 0)
+			m_core->i_clk = v;
+		else
+			m_core->i_pixclk = v;
+	}
+
+	void	eval_edge(void) {
+		eval();
+		if (m_trace_name)
+			trace_step();
+	}
+
+	void	negedge(int k) {
+		m_changed = true;
+		if (k == m_probes.m_clock)
+			m_probes.sample(this->m_clock[k].ticks());
+		if (k == 0)
+			static_cast<TB *>(this)->sim_clk_tick();
+		else
+			static_cast<TB *>(this)->sim_pixclk_tick();
+	}
+	// }}}
+
+	void	tick(void) {
+		this->step();
+	}
+
+	// Your test fixture should hide these two methods with its own.
+	// If you change any of the inputs to the design (i.e. w/in main.v),
+	// then set m_changed to true.
+	void	sim_clk_tick(void) {
 			m_changed = false;
 		}
-	virtual	void	sim_pixclk_tick(void) {
-			// Your test fixture should over-ride this method.
-			// If you change any of the inputs to the design
-			// (i.e. w/in main.v), then set m_changed to true.
+	void	sim_pixclk_tick(void) {
 			m_changed = false;
 		}
+
 	virtual bool	done(void) {
 		if (m_done)
 			return true;
 
+#ifdef	ROOT_VERILATOR
+		if (m_context->gotFinish())
+#else
 		if (Verilated::gotFinish())
+#endif
 			m_done = true;
 
 		return m_done;
 	}
 
-	virtual	void	reset(void) {
+	void	reset(void) {
 		m_core->i_reset = 1;
-		tick();
+		static_cast<TB *>(this)->tick();
 		m_core->i_reset = 0;
 		// printf("RESET\n");
 	}
+
+	// Checkpoint/restore
+	// {{{
+	// A snapshot file contains the Verilated model, as saved by Verilator
+	// (the design must be Verilated with --savable), followed by the
+	// length of the state of the test bench itself, that state, and the
+	// length once more (complemented) to show the file wasn't cut short.
+	// Test benches with any state of their own (memories, A/D models,
+	// video decoders, etc.) should extend save_state() and
+	// restore_state() to cover it.
+	virtual	void	save_state(FILE *fp) {
+		this->save_clocks(fp);
+	}
+
+	virtual	bool	restore_state(FILE *fp) {
+		return this->restore_clocks(fp);
+	}
+
+	bool	save(const char *fname) {
+#ifdef	NO_SAVABLE
+		// The design was Verilated without --savable
+		fprintf(stderr, "ERR: Built without checkpoints, cannot save %s\n",
+			fname);
+		return false;
+#else
+		VerilatedSave	os;
+		char		*buf = NULL;
+		size_t		len = 0;
+		uint64_t	ln;
+		FILE		*fp;
+
+		os.open(fname);
+		if (!os.isOpen()) {
+			fprintf(stderr, "ERR: Cannot open %s to save\n", fname);
+			return false;
+		}
+
+		os << *m_core;
+
+		fp = open_memstream(&buf, &len);
+		save_state(fp);
+		fclose(fp);
+
+		ln = len;
+		os.write(&ln, sizeof(ln));
+		os.write(buf, len);
+		ln = ~ln;
+		os.write(&ln, sizeof(ln));
+		os.close();
+		free(buf);
+
+		return true;
+#endif
+	}
+
+	bool	restore(const char *fname) {
+#ifdef	NO_SAVABLE
+		// The design was Verilated without --savable
+		fprintf(stderr, "ERR: Built without checkpoints, cannot restore %s\n",
+			fname);
+		return false;
+#else
+		VerilatedRestore	is;
+		struct stat	sb;
+		char		*buf;
+		uint64_t	ln, chk;
+		FILE		*fp;
+		bool		r;
+
+		if (stat(fname, &sb) != 0) {
+			fprintf(stderr, "ERR: Cannot open %s to restore\n",
+				fname);
+			perror("O/S Err:");
+			return false;
+		}
+
+		is.open(fname);
+		if (!is.isOpen()) {
+			fprintf(stderr, "ERR: Cannot open %s to restore\n",
+				fname);
+			return false;
+		}
+
+		// Verilator reads zeros, rather than failing, past the end of
+		// the file.  Hence the length is checked against the file's,
+		// and the state against the check word following it.
+		is >> *m_core;
+		is.read(&ln, sizeof(ln));
+		if (!is.isOpen() || ln >= (uint64_t)sb.st_size) {
+			fprintf(stderr, "ERR: %s is not a snapshot of this test bench\n", fname);
+			is.close();
+			return false;
+		}
+
+		if (!(buf = (char *)malloc(ln+1))) {
+			fprintf(stderr, "ERR: No memory to restore %s\n", fname);
+			is.close();
+			return false;
+		}
+
+		is.read(buf, ln);
+		is.read(&chk, sizeof(chk));
+		r = is.isOpen() && chk == ~ln;
+		is.close();
+		if (!r) {
+			fprintf(stderr, "ERR: %s is truncated, or not a snapshot of this test bench\n", fname);
+			free(buf);
+			return false;
+		}
+		buf[ln] = 0;
+
+		if (!(fp = fmemopen(buf, ln+1, "rb"))) {
+			perror("O/S Err:");
+			free(buf);
+			return false;
+		}
+		r = restore_state(fp);
+		fclose(fp);
+		free(buf);
+
+		if (!r)
+			fprintf(stderr, "ERR: Could not restore %s\n", fname);
+		return r;
+#endif
+	}
+	// }}}
 };
 
 #endif	// TESTB
@@ -0,0 +1,122 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/threadpool.cpp
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	A (very) simple pool of threads, as described in threadpool.h.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "threadpool.h"
+
+typedef	struct	POOL_S {
+	pthread_mutex_t	m_lock;
+	int		m_next, m_njobs;
+	void		(*m_fn)(void *, int);
+	void		*m_arg;
+} POOL;
+
+static	void	*worker(void *vp) {
+	// {{{
+	POOL	*pool = (POOL *)vp;
+
+	for(;;) {
+		int	job;
+
+		pthread_mutex_lock(&pool->m_lock);
+		job = pool->m_next;
+		if (job < pool->m_njobs)
+			pool->m_next++;
+		pthread_mutex_unlock(&pool->m_lock);
+
+		if (job >= pool->m_njobs)
+			break;
+		pool->m_fn(pool->m_arg, job);
+	}
+
+	return NULL;
+}
+// }}}
+
+void	run_pool(int njobs, int nthreads, void (*fn)(void *, int), void *arg) {
+	// {{{
+	POOL		pool;
+	pthread_t	*threads;
+	int		nt;
+
+	if (nthreads > njobs)
+		nthreads = njobs;
+	if (nthreads < 1)
+		nthreads = 1;
+
+	pthread_mutex_init(&pool.m_lock, NULL);
+	pool.m_next  = 0;
+	pool.m_njobs = njobs;
+	pool.m_fn    = fn;
+	pool.m_arg   = arg;
+
+	if (nthreads == 1) {
+		// No need for any threads
+		worker(&pool);
+		pthread_mutex_destroy(&pool.m_lock);
+		return;
+	}
+
+	threads = new pthread_t[nthreads];
+	for(nt=0; nt<nthreads; nt++) {
+		if (pthread_create(&threads[nt], NULL, worker, &pool) != 0) {
+			perror("O/S Err:");
+			break;
+		}
+	}
+
+	if (nt == 0)
+		// Couldn't create any threads at all, so run everything here
+		worker(&pool);
+
+	for(int k=0; k<nt; k++)
+		pthread_join(threads[k], NULL);
+
+	delete[] threads;
+	pthread_mutex_destroy(&pool.m_lock);
+}
+// }}}
+
+int	nprocessors(void) {
+	long	n = sysconf(_SC_NPROCESSORS_ONLN);
+
+	return (n > 0) ? (int)n : 1;
+}
@@ -0,0 +1,51 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/threadpool.h
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Runs a number of independent jobs, such as whole simulations,
+//		over a pool of threads.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#ifndef	THREADPOOL_H
+#define	THREADPOOL_H
+
+// Calls fn(arg, k) once for every k from 0 to njobs-1, spreading the calls
+// over nthreads threads.  Jobs are handed out in order, to whichever thread
+// is free next.  Returns once every job has finished.
+extern	void	run_pool(int njobs, int nthreads,
+			void (*fn)(void *arg, int job), void *arg);
+
+// The number of processors available, to size a pool by
+extern	int	nprocessors(void);
+
+#endif
@@ -0,0 +1,146 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/tracewin.cpp
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Parses the description of a trace window.  The window itself is
+//		applied, step by step, by the inline code in tracewin.h.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tracewin.h"
+
+void	TRACEWIN::clear(void) {
+	// {{{
+	m_frame = m_clock = m_length_ps = m_clocks = m_pre_ps = 0;
+	m_flush_ps = 1000000000ul;	// 1ms
+	m_on_name[0] = m_off_name[0] = '\0';
+	m_on_inv = m_off_inv = false;
+	m_on = m_off = NULL;
+	m_state = TW_WAIT;
+	m_start_ps = m_start_clk = 0;
+	m_last_on = m_last_off = false;
+}
+// }}}
+
+bool	TRACEWIN::duration(const char *str, unsigned long &ps) {
+	// {{{
+	char	*ptr;
+	double	v;
+
+	v = strtod(str, &ptr);
+	if (ptr == str || v < 0)
+		return false;
+
+	if (*ptr == '\0' || strcmp(ptr, "ps") == 0)
+		;
+	else if (strcmp(ptr, "ns") == 0)
+		v *= 1e3;
+	else if (strcmp(ptr, "us") == 0)
+		v *= 1e6;
+	else if (strcmp(ptr, "ms") == 0)
+		v *= 1e9;
+	else if (strcmp(ptr, "s") == 0)
+		v *= 1e12;
+	else
+		return false;
+
+	ps = (unsigned long)(v + 0.5);
+	return true;
+}
+// }}}
+
+static	bool	signame(const char *str, char *name, bool &inv) {
+	// {{{
+	inv = (*str == '!');
+	if (inv)
+		str++;
+	if (!*str || strlen(str) >= 64)
+		return false;
+	strcpy(name, str);
+	return true;
+}
+// }}}
+
+bool	TRACEWIN::parse(const char *spec) {
+	// {{{
+	char	*buf, *tok, *val, *save;
+	bool	ok = true;
+
+	clear();
+	if (!spec)
+		return true;
+
+	buf = strdup(spec);
+	for(tok = strtok_r(buf, ",", &save); tok && ok;
+			tok = strtok_r(NULL, ",", &save)) {
+		char	*end;
+
+		val = strchr(tok, '=');
+		if (!val) {
+			ok = false;
+			break;
+		}
+		*val++ = '\0';
+
+		if (strcmp(tok, "frame") == 0) {
+			m_frame = strtoul(val, &end, 0);
+			ok = (end != val && *end == '\0');
+		} else if (strcmp(tok, "clock") == 0) {
+			m_clock = strtoul(val, &end, 0);
+			ok = (end != val && *end == '\0');
+		} else if (strcmp(tok, "clocks") == 0) {
+			m_clocks = strtoul(val, &end, 0);
+			ok = (end != val && *end == '\0');
+		} else if (strcmp(tok, "on") == 0)
+			ok = signame(val, m_on_name, m_on_inv);
+		else if (strcmp(tok, "off") == 0)
+			ok = signame(val, m_off_name, m_off_inv);
+		else if (strcmp(tok, "for") == 0)
+			ok = duration(val, m_length_ps);
+		else if (strcmp(tok, "pre") == 0)
+			ok = duration(val, m_pre_ps);
+		else if (strcmp(tok, "flush") == 0)
+			ok = duration(val, m_flush_ps) && m_flush_ps > 0;
+		else
+			ok = false;
+	}
+
+	if (!ok)
+		fprintf(stderr, "ERR: Cannot parse trace window, %s\n", spec);
+	free(buf);
+	return ok;
+}
+// }}}
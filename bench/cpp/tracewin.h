@@ -0,0 +1,163 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/tracewin.h
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Describes a window of time to be traced, and when it begins and
+//		ends, so that a long simulation can be traced around just the
+//	event of interest rather than from start to finish.
+//
+//	For example, "frame=150,on=fft_sync,for=2ms,pre=50us" traces from the
+//	first rising edge of fft_sync after frame 150 for 2 ms, together with
+//	at least the 50 us leading up to it.  The test bench owning the trace
+//	(see testb.h) maps signal names to signals, and handles the files.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#ifndef	TRACEWIN_H
+#define	TRACEWIN_H
+
+// TRACEWIN
+// {{{
+// Decides when a trace should begin and end.  The window opens once both
+// m_frame frames and m_clock system clocks have gone by and then, if given,
+// on the next rising edge of the m_on signal.  It closes m_length_ps
+// picoseconds or m_clocks clocks later, or on the next rising edge of the
+// m_off signal--whichever comes first.  A zero (or NULL) means don't care.
+class	TRACEWIN {
+public:
+	enum	TWSTATE { TW_WAIT, TW_ARMED, TW_ON, TW_DONE };
+
+	// The window itself
+	unsigned long	m_frame, m_clock, m_length_ps, m_clocks,
+			m_pre_ps,	// Pre-trigger history to keep
+			m_flush_ps;	// How often to flush the trace file
+	char		m_on_name[64], m_off_name[64];
+	bool		m_on_inv, m_off_inv;
+
+	// The signals named above, once found by the test bench
+	const unsigned char	*m_on, *m_off;
+
+	TWSTATE		m_state;
+	unsigned long	m_nframes, m_start_ps, m_start_clk;
+	bool		m_last_on, m_last_off;
+
+	TRACEWIN(void) : m_nframes(0) { clear(); }
+
+	// Returns to tracing everything, from the start.  The count of frames
+	// is left alone.
+	void	clear(void);
+
+	// Parses a comma separated list of any of
+	//	frame=<n>, clock=<n>, on=[!]<signal>,
+	//	for=<time>, clocks=<n>, off=[!]<signal>,
+	//	pre=<time>, flush=<time>
+	// Times are in picoseconds, unless followed by ns, us, ms, or s.
+	// A '!' triggers on a falling edge rather than a rising one.
+	bool	parse(const char *spec);
+	static	bool	duration(const char *str, unsigned long &ps);
+
+	// True if nothing needs to happen before the window can open
+	bool	immediate(void) const {
+		return (m_frame == 0 && m_clock == 0 && !m_on_name[0]);
+	}
+
+	// The test bench should call this whenever a frame completes
+	void	frame(unsigned long n) { m_nframes = n; }
+
+	bool	level(const unsigned char *sig, bool inv) const {
+		return ((*sig != 0) != inv);
+	}
+
+	// start()
+	// {{{
+	// Called on every simulation step until it returns true, at which
+	// point the window is open
+	bool	start(unsigned long t, unsigned long clocks) {
+		if (m_state == TW_WAIT) {
+			if (m_nframes < m_frame || clocks < m_clock)
+				return false;
+			if (!m_on)
+				return trigger(t, clocks);
+			// Only edges after this point count
+			m_state = TW_ARMED;
+			m_last_on = level(m_on, m_on_inv);
+			return false;
+		} else if (m_state == TW_ARMED) {
+			bool	v = level(m_on, m_on_inv), edge;
+
+			edge = (v && !m_last_on);
+			m_last_on = v;
+			if (edge)
+				return trigger(t, clocks);
+		}
+
+		return false;
+	}
+	// }}}
+
+	bool	trigger(unsigned long t, unsigned long clocks) {
+		m_state = TW_ON;
+		m_start_ps  = t;
+		m_start_clk = clocks;
+		if (m_off)
+			m_last_off = level(m_off, m_off_inv);
+		return true;
+	}
+
+	// stop()
+	// {{{
+	// Called on every simulation step while the window is open.  Returns
+	// true once it closes.
+	bool	stop(unsigned long t, unsigned long clocks) {
+		bool	r = false;
+
+		if (m_length_ps && t - m_start_ps >= m_length_ps)
+			r = true;
+		if (m_clocks && clocks - m_start_clk >= m_clocks)
+			r = true;
+		if (m_off) {
+			bool	v = level(m_off, m_off_inv);
+
+			if (v && !m_last_off)
+				r = true;
+			m_last_off = v;
+		}
+
+		if (r)
+			m_state = TW_DONE;
+		return r;
+	}
+	// }}}
+};
+// }}}
+
+#endif
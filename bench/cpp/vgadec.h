@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/vgadec.h
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Decodes the VGA outputs of a Verilator based test bench into
+//		an image, without the need for any GUI.  VGASIM builds a gtkmm
+//	window on top of this.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#ifndef	VGADEC_H
+#define	VGADEC_H
+
+#include "videodec.h"
+
+class	VGADEC : public VIDEODEC {
+public:
+	static	const	bool	m_debug;
+
+	int	m_vsync_count, m_hsync_count;
+	bool	m_out_of_sync;
+
+	int	m_last_vsync, m_last_hsync, m_last_r, m_last_g, m_last_b,
+		m_pixel_clock_count;
+
+	void	initialize(void) {
+		m_vsync_count = 0;
+		m_hsync_count = 0;
+		m_out_of_sync = true;
+
+		m_last_hsync = 1;
+		m_last_vsync = 1;
+		m_last_r = m_last_g = m_last_b = 0;
+		m_pixel_clock_count = 0;
+	}
+
+public:
+	static	const	int	CLOCKS_PER_PIXEL,
+				BITS_PER_COLOR;
+
+	VGADEC(void) : VIDEODEC(640,480) {
+		initialize();
+	}
+
+	VGADEC(const int w, const int h) : VIDEODEC(w, h) {
+		initialize();
+	}
+
+	VGADEC(const char *h, const char *v) : VIDEODEC(h,v) {
+		initialize();
+	}
+
+	void	operator()(const int vsync, const int hsync,
+			const int r, const int g, const int b);
+	bool	syncd(void) const { return !m_out_of_sync; }
+
+	virtual	void	save(FILE *fp) const;
+	virtual	bool	restore(FILE *fp);
+};
+
+#endif
@@ -39,11 +39,10 @@
 #define	VGASIM_H
 
 #include <gtkmm.h>
-#include "image.h"
-#include "videomode.h"
+#include "vgadec.h"
 #include "simwin.h"
 
-class	VGASIM : public Gtk::DrawingArea {
+class	VGASIM : public Gtk::DrawingArea, public VGADEC {
 public:
 	// Type definitions ... just to make using these types easier and
 	// simpler on the fingers.
@@ -51,47 +50,25 @@ public:
 	typedef	const Cairo::RefPtr<Cairo::Context>	CONTEXT;
 	typedef	Cairo::RefPtr<Cairo::ImageSurface>	CAIROIMG;
 
-	static	const	bool	m_debug;
-
 	CAIROIMG		m_pix;
 	CAIROGC			m_gc;
-	IMAGE<unsigned>		*m_data;
-	VIDEOMODE		m_mode;
-	int	m_vsync_count, m_hsync_count;
-	bool	m_out_of_sync;
-
-	int	m_last_vsync, m_last_hsync, m_last_r, m_last_g, m_last_b,
-		m_pixel_clock_count;
 
 	void	initialize(void) {
-		m_data = new IMAGE<unsigned>(m_mode.height(), m_mode.width());
-		m_data->zeroize();
-
-		m_vsync_count = 0;
-		m_hsync_count = 0;
-		m_out_of_sync = true;
-
-		m_last_hsync = 1;
-		m_last_vsync = 1;
-
 		set_has_window(true);
 		Widget::set_can_focus(false);
 		set_size_request(m_mode.width(), m_mode.height());
 	}
 
 public:
-	static	const	int	CLOCKS_PER_PIXEL,
-				BITS_PER_COLOR;
-
-	VGASIM(void) : Gtk::DrawingArea(), m_mode(640,480) {
+	VGASIM(void) : Gtk::DrawingArea(), VGADEC(640,480) {
 		initialize();
 	}
 
-	VGASIM(const int w, const int h) : Gtk::DrawingArea(), m_mode(w, h) {
+	VGASIM(const int w, const int h) : Gtk::DrawingArea(), VGADEC(w, h) {
 		initialize();
 	}
 
-	VGASIM(const char *h, const char *v) : Gtk::DrawingArea(), m_mode(h,v) {
+	VGASIM(const char *h, const char *v) : Gtk::DrawingArea(), VGADEC(h,v) {
 		initialize();
 	}
 
@@ -139,47 +116,9 @@ public:
 
 	virtual	void	on_realize();
 
-	void	operator()(const int vsync, const int hsync,
-			const int r, const int g, const int b);
+	virtual	void	line_changed(int y, int x0, int x1);
+	virtual	bool	restore(FILE *fp);
 	virtual	bool	on_draw(CONTEXT &gc);
-	bool	syncd(void) const { return !m_out_of_sync; }
-
-
-	int	width(void) {
-		return m_mode.width();
-	}
-
-	int	height(void) {
-		return m_mode.height();
-	}
-
-	int	raw_width(void) {
-		return m_mode.raw_width();
-	}
-
-	int	raw_height(void) {
-		return m_mode.raw_height();
-	}
-
-	int	hsync(void) {
-		return m_mode.hsync();
-	}
-
-	int	vsync(void) {
-		return m_mode.vsync();
-	}
-
-	int	hporch(void) {
-		return m_mode.hporch();
-	}
-
-	int	vporch(void) {
-		return m_mode.vporch();
-	}
-
-	int	clocks_per_frame(void) const {
-		return m_mode.pixels_per_frame();
-	}
 };
 
 class	VGAWIN	: public SIMWIN {
@@ -196,6 +135,16 @@ public:
 		(*m_vgasim)(vsync, hsync, r, g, b);
 	}
 	bool	syncd(void) const { return m_vgasim->syncd(); }
+	unsigned long	nframes(void) const { return m_vgasim->nframes(); }
+	unsigned long	resyncs(void) const { return m_vgasim->resyncs(); }
+	bool	writeppm(const char *fname) const {
+		return m_vgasim->writeppm(fname); }
+	bool	diffppm(const char *fname, FRAMEDIFF &d) const {
+		return m_vgasim->diffppm(fname, d); }
+	unsigned long	hash(void) const { return m_vgasim->hash(); }
+	const unsigned	*pixels(void) const { return m_vgasim->pixels(); }
+	void	save(FILE *fp) const { m_vgasim->save(fp); }
+	bool	restore(FILE *fp) { return m_vgasim->restore(fp); }
 };
 
 #endif
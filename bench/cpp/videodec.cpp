@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/videodec.cpp
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	Implements those parts of the video decoders that are common
+//		to both VGA and HDMI, and that have no need of a GUI.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "videodec.h"
+#include "image.cpp"
+
+void	VIDEODEC::initialize(void) {
+	// {{{
+	m_data = new IMAGE<unsigned>(m_mode.height(), m_mode.width());
+	m_data->zeroize();
+	m_nframes = 0;
+	m_resyncs = 0;
+	m_hash = 0;
+	m_dirty_y = -1;
+	m_dirty_x0 = m_dirty_x1 = 0;
+}
+// }}}
+
+bool	VIDEODEC::writeppm(const char *fname) const {
+	return ::writeppm(fname, m_data->m_data, m_data->width(),
+			m_data->height());
+}
+
+bool	VIDEODEC::diffppm(const char *fname, FRAMEDIFF &d) const {
+	return ::diffppm(fname, m_data->m_data, m_data->width(),
+			m_data->height(), d);
+}
+
+void	VIDEODEC::save(FILE *fp) const {
+	// {{{
+	unsigned long	v[3] = { (unsigned long)m_data->size(), m_nframes,
+				m_resyncs };
+
+	fwrite(v, sizeof(v), 1, fp);
+	fwrite(m_data->m_data, sizeof(unsigned), m_data->size(), fp);
+}
+// }}}
+
+bool	VIDEODEC::restore(FILE *fp) {
+	// {{{
+	unsigned long	v[3];
+
+	if (fread(v, sizeof(v), 1, fp) != 1)
+		return false;
+	if (v[0] != (unsigned long)m_data->size()) {
+		fprintf(stderr, "ERR: Snapshot video mode doesn't match\n");
+		return false;
+	}
+	m_nframes = v[1];
+	m_resyncs = v[2];
+	if (fread(m_data->m_data, sizeof(unsigned), m_data->size(), fp)
+				!= (size_t)m_data->size())
+		return false;
+
+	m_dirty_y = -1;
+	m_dirty_x0 = m_dirty_x1 = 0;
+	return true;
+}
+// }}}
@@ -0,0 +1,162 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/videodec.h
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	The parts of a video "monitor" that are common to both the VGA
+//		and HDMI decoders, but that don't need (or want) a GUI: the
+//	video mode, the decoded image itself, and a count of the frames
+//	received so far.  The gtkmm simulators (VGASIM and HDMISIM) derive from
+//	the decoders built on this class, as do the headless test benches.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#ifndef	VIDEODEC_H
+#define	VIDEODEC_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "image.h"
+#include "videomode.h"
+#include "framediff.h"
+
+class	VIDEODEC {
+public:
+	IMAGE<unsigned>		*m_data;
+	VIDEOMODE		m_mode;
+	unsigned long		m_nframes,
+				m_resyncs,	// Frames during which sync was lost
+				m_hash;		// framehash() of the last frame
+	// The span of the current line that has changed: [m_dirty_x0,
+	// m_dirty_x1) of line m_dirty_y, or nothing if m_dirty_y < 0
+	int			m_dirty_y, m_dirty_x0, m_dirty_x1;
+
+	VIDEODEC(const int w, const int h) : m_mode(w, h) {
+		initialize();
+	}
+
+	VIDEODEC(const char *h, const char *v) : m_mode(h, v) {
+		initialize();
+	}
+
+	virtual	~VIDEODEC(void) {
+		delete	m_data;
+	}
+
+	void	initialize(void);
+
+	// line_changed()
+	// {{{
+	// Called once for every line of the screen containing pixels that
+	// are different from the ones they had on the last frame, with the
+	// range of pixels [x0,x1) bounding all such changes.  The new colors
+	// have already been written into m_data.  Derived classes (i.e. the
+	// GUI) may use this to update their own displays a line at a time,
+	// rather than a pixel at a time.
+	virtual	void	line_changed(int y, int x0, int x1) {}
+	// }}}
+
+	// set_pixel()
+	// {{{
+	// Writes a pixel into m_data, keeping track of the range of pixels on
+	// the current line that have changed.
+	void	set_pixel(int x, int y, unsigned clr) {
+		unsigned	*pix = &m_data->m_img[y][x];
+
+		if (*pix == clr)
+			return;
+		*pix = clr;
+
+		if (y != m_dirty_y) {
+			flush_dirty();
+			m_dirty_y  = y;
+			m_dirty_x0 = x;
+		} else if (x < m_dirty_x0)
+			m_dirty_x0 = x;
+		if (x >= m_dirty_x1)
+			m_dirty_x1 = x+1;
+	}
+	// }}}
+
+	// flush_dirty()
+	// {{{
+	// Reports any outstanding changed line via line_changed().  This is
+	// called automatically any time a new line changes, and at the end of
+	// every frame.
+	void	flush_dirty(void) {
+		if (m_dirty_y >= 0)
+			line_changed(m_dirty_y, m_dirty_x0, m_dirty_x1);
+		m_dirty_y  = -1;
+		m_dirty_x0 = m_dirty_x1 = 0;
+	}
+	// }}}
+
+	// frame_done()
+	// {{{
+	// Called on the first clock of every vertical sync, once m_data holds
+	// the complete (prior) frame, and after m_nframes has been incremented
+	// and m_hash set.
+	virtual	void	frame_done(void) {}
+	// }}}
+
+	// Write the current contents of the screen to a (binary, P6) PPM file
+	bool	writeppm(const char *fname) const;
+
+	// Compares the current contents of the screen to those of a PPM file,
+	// as written by writeppm().  Returns false if the file can't be read,
+	// or is the wrong size.
+	bool	diffppm(const char *fname, FRAMEDIFF &d) const;
+
+	// Checkpoint support.  Derived decoders extend these to cover their
+	// own sync state.
+	virtual	void	save(FILE *fp) const;
+	virtual	bool	restore(FILE *fp);
+
+	unsigned long	nframes(void) const { return m_nframes; }
+	unsigned long	resyncs(void) const { return m_resyncs; }
+	unsigned long	hash(void) const { return m_hash; }
+	const unsigned	*pixels(void) const { return m_data->m_data; }
+
+	int	width(void) const	{ return m_mode.width(); }
+	int	height(void) const	{ return m_mode.height(); }
+	int	raw_width(void) const	{ return m_mode.raw_width(); }
+	int	raw_height(void) const	{ return m_mode.raw_height(); }
+	int	hsync(void) const	{ return m_mode.hsync(); }
+	int	vsync(void) const	{ return m_mode.vsync(); }
+	int	hporch(void) const	{ return m_mode.hporch(); }
+	int	vporch(void) const	{ return m_mode.vporch(); }
+	int	clocks_per_frame(void) const {
+		return m_mode.pixels_per_frame();
+	}
+};
+
+#endif
@@ -49,7 +49,7 @@ then
 fi
 if [[ ! -x `which ${VERILATOR}` ]];
 then
-  echo "Verilator not found in environment or in path"
+  echo "Verilator not found in environment or in path" 1>&2
   exit -1
 fi
 
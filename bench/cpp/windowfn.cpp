@@ -0,0 +1,128 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/windowfn.cpp
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	A bit exact model of rtl/fft/windowfn.v.  See windowfn.h.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "readmemh.h"
+#include "convround.h"
+#include "windowfn.h"
+
+WINDOWFN::WINDOWFN(int iw, int ow, int tw, int lgnfft)
+		: m_iw(iw), m_ow(ow), m_tw(tw), m_lgn(lgnfft) {
+	// {{{
+	m_len  = 1u << lgnfft;
+	m_taps = new int[m_len]();
+	m_hist = new int[m_len]();
+	reset();
+}
+// }}}
+
+WINDOWFN::~WINDOWFN(void) {
+	delete[] m_taps;
+	delete[] m_hist;
+}
+
+bool	WINDOWFN::load(const char *fname) {
+	// {{{
+	unsigned	*v = new unsigned[m_len]();
+	int		n;
+
+	if ((n = readmemh(fname, v, m_len)) < (int)m_len) {
+		if (n >= 0)
+			fprintf(stderr, "ERR: %s holds %d taps, not %d\n",
+				fname, n, m_len);
+		delete[] v;
+		return false;
+	}
+
+	for(unsigned k=0; k<m_len; k++)
+		m_taps[k] = sbits(v[k], m_tw);
+	delete[] v;
+	return true;
+}
+// }}}
+
+void	WINDOWFN::load(const int *taps) {
+	// {{{
+	for(unsigned k=0; k<m_len; k++)
+		m_taps[k] = sbits(taps[k], m_tw);
+}
+// }}}
+
+void	WINDOWFN::reset(void) {
+	// {{{
+	memset(m_hist, 0, m_len * sizeof(int));
+	m_count = 0;
+}
+// }}}
+
+int	WINDOWFN::operator()(int s, int *out, bool *frame) {
+	// {{{
+	const	unsigned	half = m_len/2, mask = m_len-1;
+	unsigned long	j;
+	unsigned	f, k;
+
+	m_hist[m_count & mask] = sbits(s, m_iw);
+	if (++m_count < m_len) {
+		// The RTL holds o_ce low through its first_block
+		if (frame)
+			*frame = false;
+		return 0;
+	}
+
+	// This is the j'th sample of output, pairs of window taps k and k+1
+	// of frame f
+	j = m_count - m_len;
+	f = j / half;
+	k = 2 * (j % half);
+	for(int i=0; i<2; i++, k++) {
+		int64_t	product = (int64_t)m_taps[k]
+				* m_hist[(f * half + k) & mask];
+
+		if (m_ow > m_iw + m_tw)
+			out[i] = (int)(product << (m_ow - m_iw - m_tw));
+		else
+			out[i] = (int)convround(product, m_iw+m_tw, m_ow, 0);
+	}
+
+	if (frame)
+		*frame = (k == 2);
+	return 2;
+}
+// }}}
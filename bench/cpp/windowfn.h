@@ -0,0 +1,82 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bench/cpp/windowfn.h
+// {{{
+// Project:	FFT-DEMO, a verilator-based spectrogram display project
+//
+// Purpose:	A bit exact model of rtl/fft/windowfn.v, the 50% overlapped window
+//		in front of the FFT.  Given the same taps and the same samples,
+//	it produces the same outputs, in the same order, as the RTL does.
+//
+//	For every sample in, the RTL produces two out: one on i_ce, and one
+//	on i_alt_ce.  FFT frame f is the window times samples f*N/2 through
+//	f*N/2+N-1, where sample zero is the first following a reset.  Its
+//	outputs begin once N-1 samples have been received.
+//
+// Creator:	Dan Gisselquist, Ph.D.
+//		Gisselquist Technology, LLC
+//
+////////////////////////////////////////////////////////////////////////////////
+// }}}
+// Copyright (C) 2015-2024, Gisselquist Technology, LLC
+// {{{
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTIBILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program.  (It's in the $(ROOT)/doc directory.  Run make with no
+// target there if the PDF file isn't present.)  If not, see
+// <http://www.gnu.org/licenses/> for a copy.
+// }}}
+// License:	GPL, v3, as defined and found on www.gnu.org,
+// {{{
+//		http://www.gnu.org/licenses/gpl.html
+//
+////////////////////////////////////////////////////////////////////////////////
+//
+// }}}
+#ifndef	WINDOWFN_H
+#define	WINDOWFN_H
+
+#include <stdint.h>
+
+// WINDOWFN
+// {{{
+// The window function, with the parameters of main.v by default
+class	WINDOWFN {
+	int		m_iw, m_ow, m_tw, m_lgn;
+	unsigned	m_len;		// 1<<LGNFFT
+	int		*m_taps,	// The window, m_len taps of it
+			*m_hist;	// The last m_len samples
+	unsigned long	m_count;	// Samples accepted since reset
+public:
+	WINDOWFN(int iw=12, int ow=12, int tw=12, int lgnfft=10);
+	~WINDOWFN(void);
+
+	// Loads the window from a hex file (hanning.hex), or from an array
+	// of 1<<LGNFFT (TW bit) values
+	bool	load(const char *fname);
+	void	load(const int *taps);
+
+	// Returns to the state the RTL is in following a reset
+	void	reset(void);
+
+	// Accepts the next sample (the low IW bits of s), as the RTL would
+	// on i_ce.  Writes the outputs the RTL would produce on this i_ce
+	// and the following i_alt_ce to out, and returns how many there
+	// were: two, or none while the first frame is filling.  *frame is set
+	// if the first of them is the first of an FFT frame (o_frame).
+	int	operator()(int s, int *out, bool *frame = 0);
+
+	int	size(void) const { return m_len; }
+};
+// }}}
+
+#endif
@@ -43,6 +43,8 @@
 module	hdmiddr (
 		// {{{
 		input	wire		i_clk, i_reset, i_pixclk,
+		// Which of the colormaps (see colormap.v) to display with
+		input	wire	[2:0]	i_cmap,
 		// External bus interface
 		// {{{
 		output	wire			o_sdram_cyc, o_sdram_stb, o_sdram_we,
@@ -60,6 +62,11 @@ module	hdmiddr (
 		// {{{
 		output	wire		o_adc_csn, o_adc_sck,
 		input	wire		i_adc_miso,
+`ifdef	ADC_BYPASS
+		// Simulation only: samples given directly, skipping the SPI
+		input	wire		i_adc_ce,
+		input	wire	[11:0]	i_adc_sample,
+`endif
 		// }}}
 		// 8x LEDs
 		output	wire	[7:0]	o_led
@@ -86,30 +93,33 @@ module	hdmiddr (
 	wire	[3:0]		dat_sel;
 	//
 	// wire	[31:0]		mem_in, mem_data;
-	wire			dat_stall, video_stall, // mem_stall,
+	// Those signals marked public may be probed by the test bench
+	wire			dat_stall /* verilator public_flat_rd */;
+	wire			video_stall, // mem_stall,
 				dat_ack, video_ack, // mem_ack,
 				dat_err, video_err; // mem_err;
 	// wire	[3:0]		mem_sel;
 	reg			adc_start;
 	reg	[6:0]		adc_divider;
 	wire			adc_ign;
-	wire			adc_ce;
-	wire	[11:0]		adc_sample;
+	wire			adc_ce /* verilator public_flat_rd */;
+	wire	[11:0]		adc_sample /* verilator public_flat_rd */;
 	reg	[31:0]		adc_led_counter;
-	wire			fil_ce;
-	wire	[20:0]		fil_sample;
+	wire			fil_ce /* verilator public_flat_rd */;
+	wire	[20:0]		fil_sample /* verilator public_flat_rd */;
 	reg	[31:0]		fltr_led_counter;
 	reg			alt_ce;
 	reg	[6:0]		alt_countdown;
-	wire			pre_frame, pre_ce;
-	wire	[11:0]		pre_sample;
-	wire			fft_sync;
-	wire	[31:0]		fft_sample;
-	wire			raw_sync;
-	wire	[7:0]		raw_pixel;
+	wire			pre_frame;
+	wire			pre_ce /* verilator public_flat_rd */;
+	wire	[11:0]		pre_sample /* verilator public_flat_rd */;
+	wire			fft_sync /* verilator public_flat_rd */;
+	wire	[31:0]		fft_sample /* verilator public_flat_rd */;
+	wire			raw_sync /* verilator public_flat_rd */;
+	wire	[7:0]		raw_pixel /* verilator public_flat_rd */;
 	wire	[AW-1:0]	baseoffset;
 	wire	[AW-1:0]	last_line_addr;
-	wire			video_refresh;
+	wire			video_refresh /* verilator public_flat_rd */;
 	wire	[AW-1:0]	read_offset;
 
 	reg	[31:0]		frame_led_count;
@@ -151,6 +161,16 @@ module	hdmiddr (
 	//
 	//
 
+`ifdef	ADC_BYPASS
+	// Skip the SPI controller (and the simulated A/D on the other side
+	// of it) entirely.  The test bench provides one sample every 100
+	// clocks on its own.
+	assign	o_adc_csn  = 1'b1;
+	assign	o_adc_sck  = 1'b1;
+	assign	adc_ign    = 1'b0;
+	assign	adc_ce     = i_adc_ce;
+	assign	adc_sample = i_adc_sample;
+`else
 	pmic
 	adc(
 		// {{{
@@ -158,6 +178,7 @@ module	hdmiddr (
 			{ adc_ign, adc_ce, adc_sample }
 		// }}}
 	);
+`endif
 
 	// adc_led_counter: Create a 1Hz LED flash from our sample clock
 	// {{{
@@ -430,6 +451,7 @@ module	hdmiddr (
 		BASEADDR + read_offset, LINEWORDS[FW:0],
 		HWIDTH,  HPORCH, HSYNC, HRAW,	// Horizontal mode
 		LHEIGHT, LPORCH, LSYNC, LRAW,	// Vertical mode
+		i_cmap,
 		// Wishbone
 		video_cyc, video_stb, video_addr,
 			video_ack, video_err, video_stall, i_sdram_data,
@@ -636,6 +658,10 @@ module	hdmiddr (
 	assign	unused = &{ 1'b0, fil_sample[20], fil_sample[8:0],
 			pre_frame, adc_ign, video_refresh,
 			adc_mag, fil_mag, pix_mag };
+`ifdef	ADC_BYPASS
+	wire	bypass_unused;
+	assign	bypass_unused = &{ 1'b0, i_adc_miso, adc_start };
+`endif
 	// verilator lint_on  UNUSED		
 	// }}}
 endmodule
@@ -50,8 +50,15 @@ module	main (
 		input	wire		i_reset,
 		// Verilator lint_on  SYNCASYNCNET
 		input	wire		i_pixclk,
+		// Which of the colormaps (see colormap.v) to display with
+		input	wire	[2:0]	i_cmap,
 		output	wire		o_adc_csn, o_adc_sck,
 		input	wire		i_adc_miso,
+`ifdef	ADC_BYPASS
+		// Simulation only: samples given directly, skipping the SPI
+		input	wire		i_adc_ce,
+		input	wire	[11:0]	i_adc_sample,
+`endif
 		output	wire		o_vga_vsync, o_vga_hsync,
 		output	wire	[7:0]	o_vga_red, o_vga_grn, o_vga_blu,
 		// These wires are used for debugging the verilator simulation
@@ -81,7 +88,9 @@ module	main (
 	wire	[3:0]		dat_sel;
 	//
 	wire	[31:0]		mem_in, mem_data;
-	wire			dat_stall, video_stall, mem_stall,
+	// Those signals marked public may be probed by the test bench
+	wire			dat_stall /* verilator public_flat_rd */;
+	wire			video_stall, mem_stall,
 				dat_ack, video_ack, mem_ack,
 				dat_err, video_err, mem_err;
 	wire	[3:0]		mem_sel;
@@ -91,22 +100,23 @@ module	main (
 	reg	[6:0]		adc_divider;
 
 	wire		adc_ign;
-	wire		adc_ce;
-	wire	[11:0]	adc_sample;
-	wire		fil_ce;
-	wire	[19:0]	fil_sample;
+	wire		adc_ce /* verilator public_flat_rd */;
+	wire	[11:0]	adc_sample /* verilator public_flat_rd */;
+	wire		fil_ce /* verilator public_flat_rd */;
+	wire	[19:0]	fil_sample /* verilator public_flat_rd */;
 
 	reg		alt_ce;
 	reg	[4:0]	alt_countdown;
 
-	wire		pre_frame, pre_ce;
-	wire	[11:0]	pre_sample;	
+	wire		pre_frame;
+	wire		pre_ce /* verilator public_flat_rd */;
+	wire	[11:0]	pre_sample /* verilator public_flat_rd */;
 
-	wire		fft_sync;
-	wire	[31:0]	fft_sample;
+	wire		fft_sync /* verilator public_flat_rd */;
+	wire	[31:0]	fft_sample /* verilator public_flat_rd */;
 
-	wire		raw_sync;
-	wire	[7:0]	raw_pixel;
+	wire		raw_sync /* verilator public_flat_rd */;
+	wire	[7:0]	raw_pixel /* verilator public_flat_rd */;
 
 	localparam	LGMEM=21, AW=LGMEM-2;	// LGDW = 5
 	localparam	FW=13, LW=12;
@@ -118,7 +128,7 @@ module	main (
 	wire	[AW-1:0]	baseoffset;
 	wire	[AW-1:0]	last_line_addr;
 
-	wire			video_refresh;
+	wire			video_refresh /* verilator public_flat_rd */;
 
 	wire	[AW-1:0]	read_offset;
 	// }}}
@@ -141,8 +151,19 @@ module	main (
 		adc_start <= 0;
 	end
 
+`ifdef	ADC_BYPASS
+	// Skip the SPI controller (and the simulated A/D on the other side
+	// of it) entirely.  The test bench provides one sample every 100
+	// clocks on its own.
+	assign	o_adc_csn  = 1'b1;
+	assign	o_adc_sck  = 1'b1;
+	assign	adc_ign    = 1'b0;
+	assign	adc_ce     = i_adc_ce;
+	assign	adc_sample = i_adc_sample;
+`else
 	pmic adc(i_clk, adc_start, 1'b1, 1'b1, o_adc_csn, o_adc_sck, i_adc_miso,
 			{ adc_ign, adc_ce, adc_sample });
+`endif
 	// }}}
 	////////////////////////////////////////////////////////////////////////
 	//
@@ -374,6 +395,7 @@ module	main (
 		BASEADDR + read_offset, LINEWORDS[FW:0],
 		HWIDTH,  HPORCH, HSYNC, HRAW,	// Horizontal mode
 		LHEIGHT, LPORCH, LSYNC, LRAW,	// Vertical mode
+		i_cmap,
 		// Wishbone
 		video_cyc, video_stb, video_addr,
 			video_ack, video_err, video_stall, mem_data,
@@ -389,6 +411,10 @@ module	main (
 	wire	unused;
 	assign	unused = &{ 1'b0, fil_sample[19:12], pre_frame, adc_ign,
 			video_refresh };
+`ifdef	ADC_BYPASS
+	wire	bypass_unused;
+	assign	bypass_unused = &{ 1'b0, i_adc_miso, adc_start };
+`endif
 	// verilator lint_on  UNUSED		
 	// }}}
 endmodule
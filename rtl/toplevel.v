@@ -156,6 +156,8 @@ module	toplevel(i_clk,
 	//
 
 	hdmiddr	thedesign(s_clk, s_reset, s_pixclk,
+		// The colormap is fixed in hardware, to gtmap.v
+		3'h4,
 		// The SDRAM interface to an toplevel AXI4 module
 		//
 		sdram_cyc, sdram_stb, sdram_we,
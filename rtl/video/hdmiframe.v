@@ -66,6 +66,9 @@ module	hdmiframe #(
 						i_hm_synch, i_hm_raw,
 		input	wire	[(LW-1):0] i_vm_height, i_vm_porch,
 						i_vm_synch, i_vm_raw,
+		// Which colormap to use.  Sampled on the pixel clock, and
+		// hence only expected to change between frames.
+		input	wire	[2:0]		i_cmap,
 		// }}}
 		// Wishbone interface
 		// {{{
@@ -158,7 +161,7 @@ module	hdmiframe #(
 	colormap
 	cmap(
 		// {{{
-		i_pixclk, 3'h4, cmap_data[31:24],
+		i_pixclk, i_cmap, cmap_data[31:24],
 		pixel[23:16], pixel[15:8], pixel[7:0]
 		// }}}
 	);